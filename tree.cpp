@@ -1,4 +1,5 @@
 #include <iostream>
+#include <climits>
 using namespace std;
 
 #include <vector>
@@ -11,6 +12,35 @@ using namespace std;
 #include <algorithm> // reverse
 #include <string>
 #include <sstream>
+#include <string_view>
+#include <array>
+#include <cstdint>
+#include <cmath>
+#include <thread> // parallel versions
+#include <future>
+#include <atomic> // concurrent BST
+#include <mutex>
+#include <memory> // persistent BST
+#if __cplusplus >= 202002L
+#include <ranges> // lazy traversal ranges
+#endif
+#include <chrono> // benchmarks
+#include <random>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <cerrno>
+#include <charconv> // streaming codec
+#include <fcntl.h> // mmap snapshots
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __AVX2__
+#include <immintrin.h> // batched Eytzinger descent, B+ tree node search
+#endif
+#ifdef __SSE2__
+#include <emmintrin.h> // text codec comma masks
+#endif
 
 struct TreeNode
 {
@@ -18,7 +48,7 @@ struct TreeNode
     TreeNode *left;
     TreeNode *right;
     TreeNode *parent;
-    TreeNode(int x) : val(x), left(nullptr), right(nullptr) {}
+    TreeNode(int x) : val(x), left(nullptr), right(nullptr), parent(nullptr) {}
     // Always use initializer lists for constructors instead of assignment inside constructor body
 };
 
@@ -48,6 +78,84 @@ class Person {
 // Initializer List runs before body
 // Assignment in Body runs after members default-constructed
 
+// ! Node arena
+// Every builder below does `new TreeNode` once per node → one malloc per node and nothing frees them.
+// TreeArena hands out nodes from big 64-byte aligned blocks (2 nodes per cache line, siblings
+// built together sit next to each other) and frees the whole tree at once when the arena is dropped.
+// Nodes taken from an arena must NOT be `delete`d one by one.
+class TreeArena
+{
+    static const size_t BLOCK = 4096; // nodes per block
+    vector<TreeNode *> blocks;
+    size_t used = BLOCK; // nodes handed out from the last block
+
+public:
+    TreeArena() {}
+    TreeArena(const TreeArena &) = delete;
+    TreeArena &operator=(const TreeArena &) = delete;
+    ~TreeArena() { release(); }
+
+    TreeNode *make(int x)
+    {
+        if (used == BLOCK)
+        {
+            void *mem = ::operator new(BLOCK * sizeof(TreeNode), align_val_t(64));
+            blocks.push_back(static_cast<TreeNode *>(mem));
+            used = 0;
+        }
+        // TreeNode is trivially destructible, so placement new is all we need
+        return new (blocks.back() + used++) TreeNode(x);
+    }
+
+    // drop every node at once: one free per block, no per-node walk
+    void release()
+    {
+        for (TreeNode *b : blocks)
+            ::operator delete(b, align_val_t(64));
+        blocks.clear();
+        used = BLOCK;
+    }
+
+    size_t size() const
+    {
+        return blocks.empty() ? 0 : (blocks.size() - 1) * BLOCK + used;
+    }
+};
+// make(): O(1), one allocation per 4096 nodes
+// release(): O(n / 4096) frees, no traversal
+
+// All builders take an optional arena; without one they fall back to plain `new`
+TreeNode *newNode(int x, TreeArena *arena)
+{
+    return arena ? arena->make(x) : new TreeNode(x);
+}
+// Arena nodes are reclaimed together with their arena, only heap nodes get deleted
+void dropNode(TreeNode *node, TreeArena *arena)
+{
+    if (!arena)
+        delete node;
+}
+
+// Free a heap-built (no arena) tree, iteratively so skewed trees don't blow the stack
+void freeTree(TreeNode *root)
+{
+    if (!root)
+        return;
+    stack<TreeNode *> st;
+    st.push(root);
+    while (!st.empty())
+    {
+        TreeNode *node = st.top();
+        st.pop();
+        if (node->left)
+            st.push(node->left);
+        if (node->right)
+            st.push(node->right);
+        delete node;
+    }
+}
+// TC O(n), SC O(h)
+
 void inOrder(TreeNode *root)
 {
     if (!root)
@@ -57,7 +165,7 @@ void inOrder(TreeNode *root)
     inOrder(root->right);
 }
 TreeNode *root;
-void createTree()
+void createTree(TreeArena *arena = nullptr)
 {
     int x;
     cout << "enter root ";
@@ -67,7 +175,7 @@ void createTree()
         root = nullptr;
         return;
     }
-    root = new TreeNode(x);
+    root = newNode(x, arena);
     queue<TreeNode *> q;
     q.push(root);
     while (!q.empty())
@@ -79,14 +187,14 @@ void createTree()
         cin >> nextTreeNode;
         if (nextTreeNode != -1)
         {
-            curr->left = new TreeNode(nextTreeNode);
+            curr->left = newNode(nextTreeNode, arena);
             q.push(curr->left);
         }
         cout << "enter right of " << curr->val << " ";
         cin >> nextTreeNode;
         if (nextTreeNode != -1)
         {
-            curr->right = new TreeNode(nextTreeNode);
+            curr->right = newNode(nextTreeNode, arena);
             q.push(curr->right);
         }
     }
@@ -360,6 +468,128 @@ vector<vector<int>> verticalTraversal(TreeNode *root)
     return res;
 }
 
+// ! Vertical / top view with column offset arrays (no maps)
+/*
+Columns of an n-node tree are a contiguous range [lo, hi] with hi - lo < n, so
+a column is just an index (col - lo) into a flat array — no map needed.
+
+1. BFS over a plain vector (the vector is the queue) records col/row/val of
+   every node and the min/max column.
+2. Counting sort by column: count, prefix sum, scatter. The scatter is stable
+   and BFS emits rows in increasing order, so inside each column the entries
+   are already sorted by row.
+3. Only equal-row runs inside a column still need sorting by value; those runs
+   are tiny, so a plain sort on each one is enough.
+Top view needs even less: BFS reaches columns outward one at a time, so the
+first node of a new column is always one past the current edge — two growing
+arrays (left of root, right of root) replace the map.
+Allocations: a handful of O(n) arrays + the result, instead of one tree node
+per map/multiset entry.
+*/
+struct ColumnScan
+{
+    vector<int> col, row, val; // BFS order
+    int lo = 0, hi = 0;
+};
+
+ColumnScan scanColumns(TreeNode *root)
+{
+    ColumnScan s;
+    if (!root)
+        return s;
+    vector<TreeNode *> q{root};
+    s.col.push_back(0);
+    s.row.push_back(0);
+    for (size_t head = 0; head < q.size(); head++)
+    {
+        TreeNode *node = q[head];
+        int c = s.col[head], r = s.row[head];
+        s.val.push_back(node->val);
+        s.lo = min(s.lo, c);
+        s.hi = max(s.hi, c);
+        if (node->left)
+        {
+            q.push_back(node->left);
+            s.col.push_back(c - 1);
+            s.row.push_back(r + 1);
+        }
+        if (node->right)
+        {
+            q.push_back(node->right);
+            s.col.push_back(c + 1);
+            s.row.push_back(r + 1);
+        }
+    }
+    return s;
+}
+
+vector<int> topViewColumns(TreeNode *root)
+{
+    if (!root)
+        return {};
+    // one pass: columns >= 0 go to right[c], columns < 0 to left[-c - 1]
+    vector<int> left, right;
+    vector<pair<TreeNode *, int>> q{{root, 0}};
+    for (size_t head = 0; head < q.size(); head++)
+    {
+        auto [node, c] = q[head];
+        if (c >= 0 && c == (int)right.size())
+            right.push_back(node->val); // first (= topmost) node seen in a new column
+        else if (c < 0 && -c - 1 == (int)left.size())
+            left.push_back(node->val);
+        if (node->left)
+            q.push_back({node->left, c - 1});
+        if (node->right)
+            q.push_back({node->right, c + 1});
+    }
+    vector<int> res(left.rbegin(), left.rend());
+    res.insert(res.end(), right.begin(), right.end());
+    return res;
+}
+// Time: O(n)
+// Space: O(n)  — vector queue, no map
+
+vector<vector<int>> verticalTraversalColumns(TreeNode *root)
+{
+    vector<vector<int>> res;
+    if (!root)
+        return res;
+    ColumnScan s = scanColumns(root);
+    int w = s.hi - s.lo + 1;
+    size_t n = s.val.size();
+
+    vector<int> start(w + 1, 0);
+    for (size_t i = 0; i < n; i++)
+        start[s.col[i] - s.lo + 1]++;
+    for (int c = 0; c < w; c++)
+        start[c + 1] += start[c];
+
+    vector<int> rows(n), vals(n), pos(start.begin(), start.end() - 1);
+    for (size_t i = 0; i < n; i++)
+    {
+        int at = pos[s.col[i] - s.lo]++;
+        rows[at] = s.row[i];
+        vals[at] = s.val[i];
+    }
+
+    res.resize(w);
+    for (int c = 0; c < w; c++)
+    {
+        // rows are non-decreasing here; sort each equal-row run by value
+        for (int i = start[c], j; i < start[c + 1]; i = j)
+        {
+            for (j = i + 1; j < start[c + 1] && rows[j] == rows[i];)
+                j++;
+            if (j - i > 1)
+                sort(vals.begin() + i, vals.begin() + j);
+        }
+        res[c].assign(vals.begin() + start[c], vals.begin() + start[c + 1]);
+    }
+    return res;
+}
+// TC: O(n + sum of k log k) over equal (col, row) groups of size k — O(n) when ties are rare
+// SC: O(n)  // flat arrays; O(width) column offsets
+
 // !width of binary tree
 int widthOfBinaryTree(TreeNode *root)
 {
@@ -428,6 +658,353 @@ vector<vector<int>> zigzagLevelOrder(TreeNode *root)
 // TC: O(N)  // each node processed once
 // SC: O(N)  // queue + result storage
 
+// ! Flat (SoA) tree
+/*
+TreeNode = 4 byte val + 3 pointers = 32 bytes, and a traversal touching only
+val/left/right still drags whole nodes scattered over the heap.
+
+FlatTree keeps the same tree as three parallel 32-bit arrays:
+    val[i], left[i], right[i]   (child = index, -1 = none)
+
+Nodes are stored in PREORDER, so
+- left child of i (if any) is always i + 1
+- a subtree is one contiguous index range
+- preorder traversal is just the val array
+DFS walks mostly move forward through memory instead of jumping around.
+*/
+struct FlatTree
+{
+    vector<int> val;
+    vector<int32_t> left, right;
+
+    int size() const { return val.size(); }
+    int root() const { return val.empty() ? -1 : 0; }
+};
+
+FlatTree toFlat(TreeNode *root)
+{
+    FlatTree t;
+    if (!root)
+        return t;
+    // node, slot to patch in its parent: 2 * parent (+1 if right child), -1 for root
+    vector<pair<TreeNode *, int64_t>> st{{root, -1}};
+    while (!st.empty())
+    {
+        auto [node, slot] = st.back();
+        st.pop_back();
+        int32_t id = t.val.size();
+        t.val.push_back(node->val);
+        t.left.push_back(-1);
+        t.right.push_back(-1);
+        if (slot >= 0)
+            (slot & 1 ? t.right : t.left)[slot / 2] = id;
+        // right pushed first so the left subtree gets the next ids
+        if (node->right)
+            st.push_back({node->right, 2 * int64_t(id) + 1});
+        if (node->left)
+            st.push_back({node->left, 2 * int64_t(id)});
+    }
+    return t;
+}
+
+TreeNode *fromFlat(const FlatTree &t, TreeArena *arena = nullptr)
+{
+    if (t.val.empty())
+        return nullptr;
+    vector<TreeNode *> nodes(t.size());
+    for (int i = 0; i < t.size(); i++)
+        nodes[i] = newNode(t.val[i], arena);
+    for (int i = 0; i < t.size(); i++)
+    {
+        if (t.left[i] != -1)
+            nodes[i]->left = nodes[t.left[i]];
+        if (t.right[i] != -1)
+            nodes[i]->right = nodes[t.right[i]];
+    }
+    return nodes[0];
+}
+// TC O(n) both ways, SC O(h) stack / O(n) id → node table
+
+// same algorithms as the TreeNode versions above, on indices
+vector<int> inorderIter(const FlatTree &t)
+{
+    vector<int> res;
+    res.reserve(t.size());
+    vector<int32_t> st;
+    int32_t cur = t.root();
+    while (cur != -1 || !st.empty())
+    {
+        while (cur != -1)
+        {
+            st.push_back(cur);
+            cur = t.left[cur];
+        }
+        cur = st.back();
+        st.pop_back();
+        res.push_back(t.val[cur]);
+        cur = t.right[cur];
+    }
+    return res;
+}
+
+// storage order is preorder already
+vector<int> preorderIter(const FlatTree &t)
+{
+    return t.val;
+}
+
+vector<int> postorderTraversal(const FlatTree &t)
+{
+    vector<int> res;
+    res.reserve(t.size());
+    vector<int32_t> st;
+    int32_t node = t.root();
+    int32_t prev = -1;
+    while (node != -1 || !st.empty())
+    {
+        while (node != -1)
+        {
+            st.push_back(node);
+            node = t.left[node];
+        }
+        node = st.back();
+        if (t.right[node] != -1 && t.right[node] != prev)
+            node = t.right[node];
+        else
+        {
+            res.push_back(t.val[node]);
+            st.pop_back();
+            prev = node;
+            node = -1;
+        }
+    }
+    return res;
+}
+
+// a plain vector is the queue: each level is the run [start, end)
+vector<vector<int>> levelOrder(const FlatTree &t)
+{
+    vector<vector<int>> res;
+    vector<int32_t> q;
+    if (t.root() != -1)
+        q.push_back(t.root());
+    size_t start = 0;
+    while (start < q.size())
+    {
+        size_t end = q.size();
+        vector<int> level;
+        level.reserve(end - start);
+        for (size_t i = start; i < end; i++)
+        {
+            int32_t node = q[i];
+            level.push_back(t.val[node]);
+            if (t.left[node] != -1)
+                q.push_back(t.left[node]);
+            if (t.right[node] != -1)
+                q.push_back(t.right[node]);
+        }
+        res.push_back(level);
+        start = end;
+    }
+    return res;
+}
+
+vector<vector<int>> zigzagLevelOrder(const FlatTree &t)
+{
+    vector<vector<int>> res = levelOrder(t);
+    for (size_t i = 1; i < res.size(); i += 2)
+        reverse(res[i].begin(), res[i].end());
+    return res;
+}
+// TC O(n) each, SC O(h) for DFS, O(n) index queue for BFS (4 bytes per node instead of a deque of pointers)
+
+// ! Level-synchronous BFS engine (frontier arrays, parallel expansion)
+/*
+levelOrder / zigzag / rightSideView / width all push and pop one node at a time
+through a std::queue. Level by level instead:
+
+    frontier = [root]
+    while frontier not empty:
+        consume(frontier)                  ← whole level, contiguous array
+        next = children of frontier, in order
+
+A wide level is split into one chunk per worker:
+  1. each worker visits its nodes and collects their children locally
+  2. prefix sums over the chunk sizes give each worker its offset in `next`,
+     and the local runs are copied there in parallel
+No locks, no queue, output order = BFS order. Small levels (< PAR_MIN nodes)
+are done on the calling thread; threads only pay off on wide levels.
+Position labels (2i / 2i+1 per level, like widthOfBinaryTree) are kept in a
+side array only when asked for, so plain traversals move 8 bytes per node.
+*/
+struct Frontier
+{
+    vector<TreeNode *> nodes;
+    vector<long long> labels; // empty unless Labels; relative to the level's first node
+
+    void clear()
+    {
+        nodes.clear();
+        labels.clear();
+    }
+};
+
+const size_t PAR_MIN = 1 << 15;
+
+// f(begin, end, chunk) over [0, m) split into `threads` chunks
+template <class F>
+void parallelChunks(size_t m, int threads, F f)
+{
+    if (threads <= 1 || m < PAR_MIN)
+    {
+        f(size_t(0), m, 0);
+        return;
+    }
+    vector<thread> pool;
+    size_t step = (m + threads - 1) / threads;
+    for (int t = 0; t < threads; t++)
+    {
+        size_t b = min(m, t * step), e = min(m, b + step);
+        pool.emplace_back(f, b, e, t);
+    }
+    for (thread &th : pool)
+        th.join();
+}
+
+// onLevel(frontier, depth) is called once per level, before it is expanded;
+// onNode(i, node) is called for frontier.nodes[i] in the same pass that reads
+// its children, so each node's cache line is touched once
+template <bool Labels, class Level, class Visit>
+void forEachLevel(TreeNode *root, int threads, Level onLevel, Visit onNode)
+{
+    if (!root)
+        return;
+    threads = max(1, threads);
+    Frontier cur, next;
+    cur.nodes.push_back(root);
+    if (Labels)
+        cur.labels.push_back(0);
+    vector<Frontier> local(threads); // per-worker children, reused across levels
+    vector<size_t> offset(threads + 1);
+    for (int depth = 0; !cur.nodes.empty(); depth++)
+    {
+        onLevel(cur, depth);
+
+        auto expand = [&](size_t b, size_t e, Frontier &out)
+        {
+            for (size_t i = b; i < e; i++)
+            {
+                TreeNode *node = cur.nodes[i];
+                onNode(i, node);
+                if (node->left)
+                    out.nodes.push_back(node->left);
+                if (node->right)
+                    out.nodes.push_back(node->right);
+                if constexpr (Labels)
+                {
+                    long long label = cur.labels[i] - cur.labels[0];
+                    if (node->left)
+                        out.labels.push_back(2 * label);
+                    if (node->right)
+                        out.labels.push_back(2 * label + 1);
+                }
+            }
+        };
+
+        next.clear();
+        if (threads == 1 || cur.nodes.size() < PAR_MIN)
+            expand(0, cur.nodes.size(), next);
+        else
+        {
+            parallelChunks(cur.nodes.size(), threads, [&](size_t b, size_t e, int t)
+                           {
+                local[t].clear();
+                expand(b, e, local[t]);
+                offset[t + 1] = local[t].nodes.size(); });
+            for (int t = 0; t < threads; t++)
+                offset[t + 1] += offset[t];
+            next.nodes.resize(offset[threads]);
+            if (Labels)
+                next.labels.resize(offset[threads]);
+            parallelChunks(cur.nodes.size(), threads, [&](size_t, size_t, int t)
+                           {
+                copy(local[t].nodes.begin(), local[t].nodes.end(), next.nodes.begin() + offset[t]);
+                copy(local[t].labels.begin(), local[t].labels.end(), next.labels.begin() + offset[t]); });
+        }
+        swap(cur, next);
+    }
+}
+
+// Flat level-order output: all values in BFS order + where each level starts
+struct LevelBuffer
+{
+    vector<int> vals;
+    vector<size_t> start; // level d = vals[start[d] .. start[d + 1])
+};
+
+LevelBuffer levelOrderBuffer(TreeNode *root, int threads = thread::hardware_concurrency(), bool zigzag = false)
+{
+    LevelBuffer out;
+    int *slot = nullptr; // first slot of the current level
+    ptrdiff_t step = 1;  // -1 on reversed zigzag levels
+    forEachLevel<false>(
+        root, threads,
+        [&](const Frontier &level, int depth)
+        {
+            size_t base = out.vals.size(), m = level.nodes.size();
+            out.start.push_back(base);
+            out.vals.resize(base + m); // workers write disjoint slots below
+            bool rev = zigzag && depth % 2 == 1;
+            slot = out.vals.data() + (rev ? base + m - 1 : base);
+            step = rev ? -1 : 1;
+        },
+        [&](size_t i, TreeNode *node)
+        { slot[step * (ptrdiff_t)i] = node->val; });
+    out.start.push_back(out.vals.size());
+    return out;
+}
+
+vector<vector<int>> levelOrderParallel(TreeNode *root, int threads = thread::hardware_concurrency())
+{
+    LevelBuffer buf = levelOrderBuffer(root, threads);
+    vector<vector<int>> res;
+    for (size_t d = 0; d + 1 < buf.start.size(); d++)
+        res.emplace_back(buf.vals.begin() + buf.start[d], buf.vals.begin() + buf.start[d + 1]);
+    return res;
+}
+
+vector<vector<int>> zigzagLevelOrderParallel(TreeNode *root, int threads = thread::hardware_concurrency())
+{
+    LevelBuffer buf = levelOrderBuffer(root, threads, true);
+    vector<vector<int>> res;
+    for (size_t d = 0; d + 1 < buf.start.size(); d++)
+        res.emplace_back(buf.vals.begin() + buf.start[d], buf.vals.begin() + buf.start[d + 1]);
+    return res;
+}
+
+// last entry of every frontier, nothing else is touched
+vector<int> rightSideViewParallel(TreeNode *root, int threads = thread::hardware_concurrency())
+{
+    vector<int> res;
+    forEachLevel<false>(
+        root, threads, [&](const Frontier &level, int)
+        { res.push_back(level.nodes.back()->val); },
+        [](size_t, TreeNode *) {});
+    return res;
+}
+
+int widthOfBinaryTreeParallel(TreeNode *root, int threads = thread::hardware_concurrency())
+{
+    long long width = 0;
+    forEachLevel<true>(
+        root, threads, [&](const Frontier &level, int)
+        { width = max(width, level.labels.back() - level.labels.front() + 1); },
+        [](size_t, TreeNode *) {});
+    return width;
+}
+// TC O(n) work, O(n / threads + levels) span
+// SC O(width) for the two frontiers (+ O(n) output)
+
 // !Binary Tree Paths
 // Given the root of a binary tree, return all root-to-leaf paths in any order.
 void getPath(TreeNode *node, string s, vector<string> &v)
@@ -584,49 +1161,266 @@ bool isSymmetric(TreeNode *root)
 // Time Complexity: O(N) — each node is compared once
 // Space Complexity: O(H) — recursion stack, H = height of tree
 
-// !child sum parent
-bool isSumProperty(TreeNode *root)
+// ! Merkle hashing + subtree dedup (hash-consing)
+/*
+isSameTree / isSymmetric walk both trees every time. Hash every subtree once,
+bottom-up, Merkle style:
+
+    h(null) = H0
+    h(node) = mix(mix(mix(val) ^ h(left)) + h(right))      (order-sensitive)
+    m(node) = same with left/right swapped → hash of the mirror image
+
+- different hashes ⇒ different trees, answered in O(1) from the cache;
+  equal hashes are confirmed by the normal walk (64-bit collisions are rare
+  but possible)
+- symmetric ⇔ h(root->left) == m(root->right)
+The cache is keyed by node address: after mutating a tree, clear() it.
+
+Hash-consing goes one step further and makes equal subtrees the SAME node:
+intern children first, then look up (val, canonical left, canonical right).
+Because the children are already canonical, comparing pointers is exact — no
+collisions to confirm. A forest full of repeated subtrees becomes a DAG that
+stores each distinct subtree once, and "equal?" is a pointer compare.
+*/
+uint64_t hashMix(uint64_t x) // splitmix64 finalizer
 {
-    // Null or leaf node always satisfies the property
-    if (!root || isLeaf(root))
-        return true;
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
 
-    int childSum = 0;
-    if (root->left)
-        childSum += root->left->val;
-    if (root->right)
-        childSum += root->right->val;
+uint64_t combineHash(int val, uint64_t left, uint64_t right)
+{
+    return hashMix(hashMix(hashMix((uint32_t)val) ^ left) + right);
+}
 
-    // Check current node + recurse
-    return (root->val == childSum) &&
-           isSumProperty(root->left) &&
-           isSumProperty(root->right);
+const uint64_t NULL_HASH = 0x6a09e667f3bcc908ULL;
 
-    // queue<TreeNode *> q;
-    // q.push(root);
+class TreeHasher
+{
+    struct Entry
+    {
+        uint64_t hash, mirror;
+    };
+    unordered_map<const TreeNode *, Entry> cache;
 
-    // while (!q.empty())
-    // {
-    //     TreeNode *node = q.front();
-    //     q.pop();
+    // iterative post-order over the not-yet-cached part of the tree
+    Entry compute(const TreeNode *root)
+    {
+        vector<pair<const TreeNode *, bool>> st{{root, false}};
+        vector<Entry> done; // child results, children before parents
+        while (!st.empty())
+        {
+            auto [node, childrenDone] = st.back();
+            st.pop_back();
+            if (!node)
+            {
+                done.push_back({NULL_HASH, NULL_HASH});
+                continue;
+            }
+            if (!childrenDone)
+            {
+                auto it = cache.find(node);
+                if (it != cache.end())
+                {
+                    done.push_back(it->second); // shared / already hashed subtree
+                    continue;
+                }
+                st.push_back({node, true});
+                st.push_back({node->right, false});
+                st.push_back({node->left, false});
+                continue;
+            }
+            Entry r = done.back();
+            done.pop_back();
+            Entry l = done.back();
+            done.pop_back();
+            Entry e{combineHash(node->val, l.hash, r.hash), combineHash(node->val, r.mirror, l.mirror)};
+            cache.emplace(node, e);
+            done.push_back(e);
+        }
+        return done.back();
+    }
 
-    //     // Skip leaf nodes
-    //     if (!node->left && !node->right)
-    //         continue;
+public:
+    uint64_t hash(const TreeNode *root)
+    {
+        return compute(root).hash;
+    }
 
-    //     int childSum = 0;
-    //     if (node->left)
-    //     {
-    //         childSum += node->left->val;
-    //         q.push(node->left);
-    //     }
-    //     if (node->right)
-    //     {
-    //         childSum += node->right->val;
-    //         q.push(node->right);
-    //     }
+    uint64_t mirrorHash(const TreeNode *root)
+    {
+        return compute(root).mirror;
+    }
 
-    //     if (node->val != childSum)
+    void clear()
+    {
+        cache.clear();
+    }
+};
+
+bool isSameTreeHashed(TreeNode *a, TreeNode *b, TreeHasher &h)
+{
+    if (a == b)
+        return true;
+    if (h.hash(a) != h.hash(b))
+        return false; // O(1) once cached
+    return isSameTree(a, b);
+}
+
+bool isSymmetricHashed(TreeNode *root, TreeHasher &h)
+{
+    if (!root)
+        return true;
+    if (h.hash(root->left) != h.mirrorHash(root->right))
+        return false;
+    return isSymmetric(root->left, root->right);
+}
+
+class SubtreeInterner
+{
+    struct Key
+    {
+        int val;
+        const TreeNode *left, *right; // already canonical
+        bool operator==(const Key &o) const
+        {
+            return val == o.val && left == o.left && right == o.right;
+        }
+    };
+    struct KeyHash
+    {
+        size_t operator()(const Key &k) const
+        {
+            return combineHash(k.val, (uintptr_t)k.left, (uintptr_t)k.right);
+        }
+    };
+    struct Slot
+    {
+        TreeNode *node;
+        long long seen; // how many input subtrees mapped here
+    };
+
+    unordered_map<Key, Slot, KeyHash> table;
+    TreeArena arena; // canonical nodes live here, shared by every interned tree
+    long long total = 0;
+
+public:
+    SubtreeInterner() = default;
+    SubtreeInterner(const SubtreeInterner &) = delete;
+    SubtreeInterner &operator=(const SubtreeInterner &) = delete;
+
+    // canonical (shared, read-only) copy of root; equal subtrees ⇒ equal pointers
+    TreeNode *intern(TreeNode *root)
+    {
+        if (!root)
+            return nullptr;
+        vector<pair<TreeNode *, bool>> st{{root, false}};
+        vector<TreeNode *> done; // canonical results, children before parents
+        while (!st.empty())
+        {
+            auto [node, childrenDone] = st.back();
+            st.pop_back();
+            if (!childrenDone)
+            {
+                st.push_back({node, true});
+                if (node->right)
+                    st.push_back({node->right, false});
+                if (node->left)
+                    st.push_back({node->left, false});
+                continue;
+            }
+            TreeNode *r = node->right ? done.back() : nullptr;
+            if (node->right)
+                done.pop_back();
+            TreeNode *l = node->left ? done.back() : nullptr;
+            if (node->left)
+                done.pop_back();
+
+            auto [it, fresh] = table.try_emplace(Key{node->val, l, r}, Slot{nullptr, 0});
+            if (fresh)
+            {
+                it->second.node = arena.make(node->val);
+                it->second.node->left = l;
+                it->second.node->right = r;
+            }
+            it->second.seen++;
+            total++;
+            done.push_back(it->second.node);
+        }
+        return done.back();
+    }
+
+    // distinct subtrees stored vs subtrees fed in
+    size_t size() const
+    {
+        return table.size();
+    }
+
+    long long inputNodes() const
+    {
+        return total;
+    }
+
+    // one representative per subtree shape that occurred more than once
+    vector<TreeNode *> duplicates() const
+    {
+        vector<TreeNode *> res;
+        for (auto &[key, slot] : table)
+            if (slot.seen > 1)
+                res.push_back(slot.node);
+        return res;
+    }
+};
+// hash / mirrorHash : O(n) once per tree, then O(1) per lookup
+// isSameTreeHashed  : O(1) when different, O(n) confirm when equal
+// intern            : O(n) expected, output memory = distinct subtrees only
+// SC                : O(n) cache / table
+
+// !child sum parent
+bool isSumProperty(TreeNode *root)
+{
+    // Null or leaf node always satisfies the property
+    if (!root || isLeaf(root))
+        return true;
+
+    int childSum = 0;
+    if (root->left)
+        childSum += root->left->val;
+    if (root->right)
+        childSum += root->right->val;
+
+    // Check current node + recurse
+    return (root->val == childSum) &&
+           isSumProperty(root->left) &&
+           isSumProperty(root->right);
+
+    // queue<TreeNode *> q;
+    // q.push(root);
+
+    // while (!q.empty())
+    // {
+    //     TreeNode *node = q.front();
+    //     q.pop();
+
+    //     // Skip leaf nodes
+    //     if (!node->left && !node->right)
+    //         continue;
+
+    //     int childSum = 0;
+    //     if (node->left)
+    //     {
+    //         childSum += node->left->val;
+    //         q.push(node->left);
+    //     }
+    //     if (node->right)
+    //     {
+    //         childSum += node->right->val;
+    //         q.push(node->right);
+    //     }
+
+    //     if (node->val != childSum)
     //         return false;
     // }
     // return true;
@@ -780,6 +1574,100 @@ TreeNode *lowestCommonAncestor(TreeNode *p, TreeNode *q)
 // TC O(H) Each pointer traverses at most 2× height
 // SC O(1) two pointers
 
+// ! LCA-5 preprocessed index: Euler tour + sparse table, O(1) per query
+/*
+LCA-1..4 pay O(N) or O(H) on every query. For millions of queries on a static
+tree, preprocess once:
+
+1. DFS (iterative) gives every node a preorder index tin[] and a depth.
+   In the Euler tour, the LCA of u and v is the shallowest node visited between
+   them. Using preorder indices (the Euler tour without the repeated entries):
+   for tin[u] < tin[v], the shallowest node in preorder range (tin[u], tin[v]]
+   is a CHILD of the LCA on the path to v, so LCA = parent of it.
+   (If u is an ancestor of v that child is on the u → v path, so we get u.)
+2. Sparse table over the preorder sequence: sp[k][i] = shallowest node in
+   [i, i + 2^k). Any range is covered by two overlapping power-of-two blocks,
+   so a range-min query is two lookups.
+*/
+class LCAIndex
+{
+    vector<TreeNode *> node;   // preorder index → node
+    vector<int> parent, depth; // by preorder index
+    vector<vector<int>> sp;    // sp[k][i]: shallowest index in [i, i + 2^k)
+    unordered_map<TreeNode *, int> tin;
+
+    int shallower(int a, int b) const
+    {
+        return depth[a] <= depth[b] ? a : b;
+    }
+
+public:
+    LCAIndex(TreeNode *root)
+    {
+        // iterative preorder: a skewed tree must not overflow the call stack
+        stack<pair<TreeNode *, int>> st; // node, parent index
+        if (root)
+            st.push({root, -1});
+        while (!st.empty())
+        {
+            auto [cur, par] = st.top();
+            st.pop();
+            int id = node.size();
+            tin[cur] = id;
+            node.push_back(cur);
+            parent.push_back(par);
+            depth.push_back(par == -1 ? 0 : depth[par] + 1);
+            if (cur->right)
+                st.push({cur->right, id});
+            if (cur->left)
+                st.push({cur->left, id});
+        }
+
+        int n = node.size();
+        sp.push_back(vector<int>(n));
+        for (int i = 0; i < n; i++)
+            sp[0][i] = i;
+        for (int k = 1; (1 << k) <= n; k++)
+        {
+            sp.push_back(vector<int>(n - (1 << k) + 1));
+            for (int i = 0; i + (1 << k) <= n; i++)
+                sp[k][i] = shallower(sp[k - 1][i], sp[k - 1][i + (1 << (k - 1))]);
+        }
+    }
+
+    // by preorder index, no hashing
+    int queryIndex(int u, int v) const
+    {
+        if (u == v)
+            return u;
+        if (u > v)
+            swap(u, v);
+        int lo = u + 1, len = v - u;
+        int k = 31 - __builtin_clz(len);
+        return parent[shallower(sp[k][lo], sp[k][v - (1 << k) + 1])];
+    }
+
+    // nullptr if p or q is not in the tree (like LCA-2/LCA-3)
+    TreeNode *query(TreeNode *p, TreeNode *q) const
+    {
+        auto a = tin.find(p), b = tin.find(q);
+        if (a == tin.end() || b == tin.end())
+            return nullptr;
+        return node[queryIndex(a->second, b->second)];
+    }
+
+    vector<TreeNode *> queryBatch(const vector<pair<TreeNode *, TreeNode *>> &queries) const
+    {
+        vector<TreeNode *> res;
+        res.reserve(queries.size());
+        for (auto &[p, q] : queries)
+            res.push_back(query(p, q));
+        return res;
+    }
+};
+// Build : O(N log N) time and space (N·log N ints)
+// Query : O(1) — one hash lookup per node + two table reads (queryIndex skips the hashing)
+
 // ! boundary traversal
 bool isLeaf(TreeNode *node)
 {
@@ -976,7 +1864,7 @@ Final Tree:
         15   7
 */
 
-TreeNode *solve(vector<int> inorder, vector<int> preorder)
+TreeNode *solve(vector<int> inorder, vector<int> preorder, TreeArena *arena = nullptr)
 {
 
     // Base case:
@@ -989,7 +1877,7 @@ TreeNode *solve(vector<int> inorder, vector<int> preorder)
     // The first element of preorder is always the ROOT
     // of the current subtree.
     int rootVal = preorder[0];
-    TreeNode *root = new TreeNode(rootVal);
+    TreeNode *root = newNode(rootVal, arena);
 
     // Step 2:
     // Find root position in inorder traversal.
@@ -1016,18 +1904,18 @@ TreeNode *solve(vector<int> inorder, vector<int> preorder)
 
     // Step 5:
     // Recursively build left and right subtrees
-    root->left = solve(leftIn, leftPre);
-    root->right = solve(rightIn, rightPre);
+    root->left = solve(leftIn, leftPre, arena);
+    root->right = solve(rightIn, rightPre, arena);
 
     // Step 6:
     // Return constructed subtree root
     return root;
 }
 
-TreeNode *buildTree(vector<int> &preorder, vector<int> &inorder)
+TreeNode *buildTree(vector<int> &preorder, vector<int> &inorder, TreeArena *arena = nullptr)
 {
     // Build tree using preorder and inorder traversals
-    return solve(inorder, preorder);
+    return solve(inorder, preorder, arena);
 }
 // One call per node → n recursion calls
 // TC = n * (find + vector copying)
@@ -1040,7 +1928,7 @@ TreeNode *buildTree(vector<int> &preorder, vector<int> &inorder)
 //    = O(n²)
 
 // !optimal
-TreeNode *buildBinaryTree(vector<int> &pre, unordered_map<int, int> &m, int inStart, int inEnd, int preStart, int preEnd)
+TreeNode *buildBinaryTree(vector<int> &pre, unordered_map<int, int> &m, int inStart, int inEnd, int preStart, int preEnd, TreeArena *arena = nullptr)
 {
     // 1. if no elements on this side, return null
     // if (in.size() == 0)
@@ -1056,24 +1944,24 @@ TreeNode *buildBinaryTree(vector<int> &pre, unordered_map<int, int> &m, int inSt
     //  pre: A B C D E F G
     // if 2 elements in left st and 4 in right st, current node A, left side
     // pre (B C) right side: skip 2, then all: DEFG
-    TreeNode *node = new TreeNode(pre[preStart]); // current node
+    TreeNode *node = newNode(pre[preStart], arena); // current node
     // vector<int> left(in.begin(), in.begin() + i);
     // vector<int> right(in.begin() + i + 1, in.end());
     // vector<int> preLeft(pre.begin() + 1, pre.begin() + i + 1);
     // vector<int> preRight(pre.begin() + i + 1, pre.end());
     //! i-inStart == number of elements on left subtree
-    node->left = buildBinaryTree(pre, m, inStart, i - 1, preStart + 1, preStart + i - inStart);
-    node->right = buildBinaryTree(pre, m, i + 1, inEnd, preStart + i - inStart + 1, preEnd);
+    node->left = buildBinaryTree(pre, m, inStart, i - 1, preStart + 1, preStart + i - inStart, arena);
+    node->right = buildBinaryTree(pre, m, i + 1, inEnd, preStart + i - inStart + 1, preEnd, arena);
     return node;
 }
-TreeNode *buildTree2(vector<int> &preorder, vector<int> &inorder)
+TreeNode *buildTree2(vector<int> &preorder, vector<int> &inorder, TreeArena *arena = nullptr)
 {
     unordered_map<int, int> m; // ele, index
     for (int i = 0; i < inorder.size(); i++)
     {
         m[inorder[i]] = i;
     }
-    return buildBinaryTree(preorder, m, 0, inorder.size() - 1, 0, preorder.size() - 1);
+    return buildBinaryTree(preorder, m, 0, inorder.size() - 1, 0, preorder.size() - 1, arena);
 }
 
 // TC = O(1) hashmap lookup × n nodes
@@ -1085,24 +1973,24 @@ TreeNode *buildTree2(vector<int> &preorder, vector<int> &inorder)
 // ! Bt from inorder, postorder
 // In postorder, the last element is root. Inorder splits left and right.
 // We recurse by skipping right subtree size in postorder.
-TreeNode *solve(int poststart, int instart, int inend, vector<int> &postorder, unordered_map<int, int> &m)
+TreeNode *solve(int poststart, int instart, int inend, vector<int> &postorder, unordered_map<int, int> &m, TreeArena *arena = nullptr)
 {
     if (instart > inend)
         return nullptr;
     int i = m[postorder[poststart]];
 
     int n = inend - i; // ele on right
-    TreeNode *node = new TreeNode(postorder[poststart]);
-    node->left = solve(poststart - n - 1, instart, i - 1, postorder, m);
-    node->right = solve(poststart - 1, i + 1, inend, postorder, m);
+    TreeNode *node = newNode(postorder[poststart], arena);
+    node->left = solve(poststart - n - 1, instart, i - 1, postorder, m, arena);
+    node->right = solve(poststart - 1, i + 1, inend, postorder, m, arena);
     return node;
 }
-TreeNode *buildTree(vector<int> &inorder, vector<int> &postorder)
+TreeNode *buildTree(vector<int> &inorder, vector<int> &postorder, TreeArena *arena = nullptr)
 {
     unordered_map<int, int> m;
     for (int i = 0; i < inorder.size(); i++)
         m[inorder[i]] = i;
-    TreeNode *root = solve(postorder.size() - 1, 0, inorder.size() - 1, postorder, m);
+    TreeNode *root = solve(postorder.size() - 1, 0, inorder.size() - 1, postorder, m, arena);
     return root;
 }
 // TC = O(1) hashmap lookup × n nodes
@@ -1111,6 +1999,80 @@ TreeNode *buildTree(vector<int> &inorder, vector<int> &postorder)
 //    = O(n) + O(n)
 //    = O(n)
 
+// ! Linear-time builders with a stack (no hashmap, no copies)
+/*
+Same idea as bstFromPreorder, but the "when do I stop going left" signal
+comes from inorder instead of from value comparisons:
+
+    walk preorder; the stack holds the current left spine
+    inorder[j] is the next node that must be "closed" (its left side is done)
+    for every new node:
+        pop while stack.top() == inorder[j] (j++) → the last popped is the parent,
+                                                    and the new node is its RIGHT child
+        nothing popped → new node is the LEFT child of stack.top()
+        push new node
+
+(post, in) is the mirror: walk postorder and inorder from the back, and
+swap left and right.
+Every node is pushed and popped once → O(n), no index map, no vector slices.
+Values must be distinct (same assumption as the hashmap versions).
+*/
+TreeNode *buildTreePreIn(const vector<int> &preorder, const vector<int> &inorder, TreeArena *arena = nullptr)
+{
+    if (preorder.empty())
+        return nullptr;
+    vector<TreeNode *> st; // left spine of the part built so far
+    TreeNode *root = newNode(preorder[0], arena);
+    st.push_back(root);
+    size_t j = 0;
+    for (size_t i = 1; i < preorder.size(); i++)
+    {
+        TreeNode *node = newNode(preorder[i], arena);
+        TreeNode *parent = nullptr;
+        while (!st.empty() && st.back()->val == inorder[j])
+        {
+            parent = st.back();
+            st.pop_back();
+            j++;
+        }
+        if (parent)
+            parent->right = node;
+        else
+            st.back()->left = node;
+        st.push_back(node);
+    }
+    return root;
+}
+
+TreeNode *buildTreePostIn(const vector<int> &postorder, const vector<int> &inorder, TreeArena *arena = nullptr)
+{
+    if (postorder.empty())
+        return nullptr;
+    vector<TreeNode *> st; // right spine of the part built so far
+    TreeNode *root = newNode(postorder.back(), arena);
+    st.push_back(root);
+    size_t j = inorder.size() - 1;
+    for (size_t i = postorder.size() - 1; i-- > 0;)
+    {
+        TreeNode *node = newNode(postorder[i], arena);
+        TreeNode *parent = nullptr;
+        while (!st.empty() && st.back()->val == inorder[j])
+        {
+            parent = st.back();
+            st.pop_back();
+            j--;
+        }
+        if (parent)
+            parent->left = node;
+        else
+            st.back()->right = node;
+        st.push_back(node);
+    }
+    return root;
+}
+// TC = O(n)  -- each node pushed and popped once
+// SC = O(h)  -- stack holds one spine, no hashmap, no recursion
+
 // ! morris inorder traversal
 // Morris Inorder Traversal
 // Idea:
@@ -1305,9 +2267,273 @@ void allTraversals(TreeNode *root)
 // Time  : O(n)
 // Space : O(n)  // stack
 
+// ! Morris traversal engine (pre / in / post) with a visitor
+/*
+inorderIter, preorderIter, postorderTraversal and allTraversals each need a
+stack (O(h)) plus an output vector (O(n)). Morris threading (see inorderTraversal
+and recoverTree) needs neither:
+
+    morrisTraverse<Order::In>(root, [&](int v) { sink.write(v); });
+
+- the order is a template argument and the visitor a template type, so each
+  use compiles to one loop with the visitor inlined, no std::function, no
+  virtual calls
+- PRE  : visit when the thread to the predecessor is created
+- IN   : visit when the thread is removed (or when there is no left child)
+- POST : thread over a dummy root; when a thread is removed, visit the right
+  chain of the left subtree bottom-up by reversing it in place, then
+  reversing it back
+The tree is modified while walking and fully restored at the end, so don't
+read it from other threads meanwhile, and let the walk run to completion.
+*/
+enum class Order
+{
+    Pre,
+    In,
+    Post
+};
+
+// reverse the right-pointer chain from → ... → to
+inline void reverseRightChain(TreeNode *from, TreeNode *to)
+{
+    if (from == to)
+        return;
+    TreeNode *x = from, *y = from->right;
+    while (x != to)
+    {
+        TreeNode *z = y->right;
+        y->right = x;
+        x = y;
+        y = z;
+    }
+}
+
+// visit the chain from → ... → to in reverse (to first), O(1) space
+template <class Visitor>
+inline void visitRightChainReversed(TreeNode *from, TreeNode *to, Visitor &visit)
+{
+    reverseRightChain(from, to);
+    for (TreeNode *p = to;; p = p->right)
+    {
+        visit(p->val);
+        if (p == from)
+            break;
+    }
+    reverseRightChain(to, from);
+}
+
+template <Order O, class Visitor>
+inline void morrisTraverse(TreeNode *root, Visitor &&visit)
+{
+    TreeNode dummy(0); // postorder only: root hangs as its left child
+    dummy.left = root;
+    TreeNode *curr = O == Order::Post ? &dummy : root;
+
+    while (curr)
+    {
+        if (!curr->left)
+        {
+            if constexpr (O != Order::Post)
+                visit(curr->val);
+            curr = curr->right;
+            continue;
+        }
+
+        TreeNode *pred = curr->left;
+        while (pred->right && pred->right != curr)
+            pred = pred->right;
+
+        if (!pred->right)
+        {
+            // first time here: thread back and go left
+            if constexpr (O == Order::Pre)
+                visit(curr->val);
+            pred->right = curr;
+            curr = curr->left;
+        }
+        else
+        {
+            // back through the thread: left subtree is done
+            if constexpr (O == Order::In)
+                visit(curr->val);
+            if constexpr (O == Order::Post)
+                visitRightChainReversed(curr->left, pred, visit);
+            pred->right = nullptr;
+            curr = curr->right;
+        }
+    }
+}
+// Time  : O(n) — every edge is walked a constant number of times (post: ≤ 4x)
+// Space : O(1) — no stack, no output buffer
+
+// ! Lazy traversal cursors and ranges
+/*
+BSTIterator (further down) is a lazy inorder walk: next() does just enough work
+to produce one value. TreeCursor<O> is the same idea for every order, and
+LevelCursor does it for BFS:
+
+    TreeCursor<Order::In> it(root);
+    while (it.hasNext()) use(it.next());
+
+With C++20 they are also ranges, so the standard views compose with them:
+
+    for (int v : inorderRange(root) | views::take(k))   // O(k + h), not O(n)
+
+- Pre  : stack of pending right subtrees (like preorderIter2)
+- In   : stack of the left spine (exactly BSTIterator)
+- Post : stack + last emitted node (like postorderTraversal)
+- Level: queue, only the current frontier is kept
+*/
+template <Order O>
+class TreeCursor
+{
+    vector<TreeNode *> st;
+    TreeNode *node = nullptr; // Post: next subtree to descend into
+    TreeNode *prev = nullptr; // Post: last emitted node
+
+    void pushLeft(TreeNode *n)
+    {
+        for (; n; n = n->left)
+            st.push_back(n);
+    }
+
+public:
+    TreeCursor(TreeNode *root = nullptr)
+    {
+        if constexpr (O == Order::Pre)
+        {
+            if (root)
+                st.push_back(root);
+        }
+        else if constexpr (O == Order::In)
+            pushLeft(root);
+        else
+            node = root;
+    }
+
+    bool hasNext() const
+    {
+        return !st.empty() || node;
+    }
+
+    int next()
+    {
+        if constexpr (O == Order::Pre)
+        {
+            TreeNode *cur = st.back();
+            st.pop_back();
+            if (cur->right)
+                st.push_back(cur->right);
+            if (cur->left)
+                st.push_back(cur->left);
+            return cur->val;
+        }
+        else if constexpr (O == Order::In)
+        {
+            TreeNode *cur = st.back();
+            st.pop_back();
+            pushLeft(cur->right);
+            return cur->val;
+        }
+        else
+        {
+            while (true)
+            {
+                pushLeft(node);
+                node = nullptr;
+                TreeNode *top = st.back();
+                if (top->right && top->right != prev)
+                    node = top->right; // right subtree not done yet
+                else
+                {
+                    st.pop_back();
+                    prev = top;
+                    return top->val;
+                }
+            }
+        }
+    }
+};
+// next(): amortized O(1), hasNext(): O(1), SC O(h)
+
+class LevelCursor
+{
+    queue<TreeNode *> q;
+
+public:
+    LevelCursor(TreeNode *root = nullptr)
+    {
+        if (root)
+            q.push(root);
+    }
+
+    bool hasNext() const
+    {
+        return !q.empty();
+    }
+
+    int next()
+    {
+        TreeNode *cur = q.front();
+        q.pop();
+        if (cur->left)
+            q.push(cur->left);
+        if (cur->right)
+            q.push(cur->right);
+        return cur->val;
+    }
+};
+// next(): O(1), SC O(width)
+
+#if __cplusplus >= 202002L
+// Wraps any cursor as a C++20 input range: begin() starts a fresh walk, end() is a sentinel.
+template <class Cursor>
+class TreeRange : public ranges::view_interface<TreeRange<Cursor>>
+{
+    TreeNode *root = nullptr;
+
+public:
+    class iterator
+    {
+        Cursor cur;
+        int val = 0;
+        bool done = true;
+
+    public:
+        using value_type = int;
+        using difference_type = ptrdiff_t;
+
+        iterator() = default;
+        explicit iterator(TreeNode *root) : cur(root) { ++*this; }
+
+        int operator*() const { return val; }
+        iterator &operator++()
+        {
+            done = !cur.hasNext();
+            if (!done)
+                val = cur.next();
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+        bool operator==(default_sentinel_t) const { return done; }
+    };
+
+    TreeRange() = default;
+    TreeRange(TreeNode *root) : root(root) {}
+    iterator begin() const { return iterator(root); }
+    default_sentinel_t end() const { return {}; }
+};
+
+TreeRange<TreeCursor<Order::Pre>> preorderRange(TreeNode *root) { return root; }
+TreeRange<TreeCursor<Order::In>> inorderRange(TreeNode *root) { return root; }
+TreeRange<TreeCursor<Order::Post>> postorderRange(TreeNode *root) { return root; }
+TreeRange<LevelCursor> levelOrderRange(TreeNode *root) { return root; }
+// first k values: O(k + h) time (O(k + width) for level order), nothing is materialized
+#endif
+
 // ! serialize deserialize bt
 // Encodes a tree to a single string (level-order)
-string serialize(TreeNode *root)
+string serialize1(TreeNode *root)
 {
     if (!root)
         return "";
@@ -1340,7 +2566,7 @@ string serialize(TreeNode *root)
 }
 
 // Decodes your encoded data to tree
-TreeNode *deserialize(string data)
+TreeNode *deserialize1(string data, TreeArena *arena = nullptr)
 {
     if (data.empty())
         return nullptr;
@@ -1350,7 +2576,7 @@ TreeNode *deserialize(string data)
 
     // Read root value
     getline(ss, token, ',');
-    TreeNode *root = new TreeNode(stoi(token));
+    TreeNode *root = newNode(stoi(token), arena);
 
     queue<TreeNode *> q;
     q.push(root);
@@ -1365,7 +2591,7 @@ TreeNode *deserialize(string data)
         {
             if (token != "N")
             {
-                node->left = new TreeNode(stoi(token));
+                node->left = newNode(stoi(token), arena);
                 q.push(node->left);
             }
         }
@@ -1375,7 +2601,7 @@ TreeNode *deserialize(string data)
         {
             if (token != "N")
             {
-                node->right = new TreeNode(stoi(token));
+                node->right = newNode(stoi(token), arena);
                 q.push(node->right);
             }
         }
@@ -1386,335 +2612,2630 @@ TreeNode *deserialize(string data)
 // Time  : O(n)
 // Space : O(n)
 
-//! BST search
-bool searchBST(TreeNode *root, int key)
+// !optimal text codec: to_chars / from_chars, no per-token strings
+/*
+serialize1 builds a temporary string per value (to_string + concat) and
+deserialize1 copies every token out of a stringstream and runs stoi on it.
+Same wire format, without the allocations:
+
+- serialize: one BFS, each value written in place with to_chars into a
+  buffer that grows geometrically (no per-value temporaries); the "N"s are
+  placed from a child-present bit recorded when the parent was dequeued,
+  so every node is touched once
+- deserialize: CommaTokens finds token boundaries 16 bytes at a time:
+  one SSE2 compare + movemask gives a bitmask of the commas in the block,
+  and each token ends at the next set bit (ctz, then clear it). So the
+  byte-by-byte delimiter search is gone; only the digits themselves go
+  through from_chars, over a string_view, no copies
+Malformed input returns nullptr instead of throwing.
+*/
+// splits [data) at ',' : next(tok) yields the tokens in order, false after the last one
+class CommaTokens
 {
-    while (root)
+    const char *start, *block, *end; // start of the next token, block the mask covers
+    uint32_t mask;                    // commas in [block, block + 16) not handed out yet
+
+    // bit k set ⇔ block[k] == ',' (bytes past end don't count)
+    static uint32_t commaMask(const char *p, const char *end)
     {
-        if (root->val == key)
-            return true;
-        else if (key < root->val)
-            root = root->left;
-        else
-            root = root->right;
+#ifdef __SSE2__
+        if (end - p >= 16)
+            return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)p), _mm_set1_epi8(',')));
+#endif
+        uint32_t m = 0;
+        for (int k = 0; k < 16 && p + k < end; k++)
+            m |= uint32_t(p[k] == ',') << k;
+        return m;
     }
-    return false;
-}
-// Time  : O(h)
-// Space : O(1)
-//! BST floor/ceil
-int floorBST(TreeNode *root, int key)
-{
-    int ans = -1;
 
-    while (root)
+public:
+    CommaTokens(string_view data) : start(data.data()), block(data.data()), end(data.data() + data.size()),
+                                    mask(commaMask(block, end)) {}
+
+    bool next(string_view &tok)
     {
-        if (root->val == key)
-            return key;
+        while (!mask)
+        {
+            block += 16;
+            if (block >= end) // no more commas: the rest is the last token
+            {
+                if (start >= end)
+                    return false;
+                tok = string_view(start, end - start);
+                start = end;
+                return true;
+            }
+            mask = commaMask(block, end);
+        }
+        const char *comma = block + __builtin_ctz(mask);
+        mask &= mask - 1;
+        tok = string_view(start, comma - start);
+        start = comma + 1;
+        return true;
+    }
+};
 
-        if (root->val < key)
+string serialize(TreeNode *root)
+{
+    if (!root)
+        return "";
+    // Child tokens of node k are tokens 2k+1, 2k+2. Values therefore appear in
+    // BFS order, with "N"s at the missing-child slots in between, so each node
+    // is written when it is dequeued and read exactly once.
+    vector<TreeNode *> order{root}; // BFS order, doubles as the queue
+    vector<char> has{1};            // has[t]: is token t a value (not "N"); token 0 = root
+    string out;
+    size_t slot = 0;
+    char *p = out.data(), *end = p;
+    for (size_t k = 0; k < order.size(); k++)
+    {
+        TreeNode *node = order[k];
+        if (end - p < 24 + 2 * (ptrdiff_t)(has.size() - slot)) // room for the Ns before us + one value
         {
-            ans = root->val; // possible floor, save when going right
-            root = root->right;
+            size_t used = p - out.data();
+            out.resize(max<size_t>(2 * out.size(), used + 24 + 2 * (has.size() - slot) + 4096));
+            p = out.data() + used;
+            end = out.data() + out.size();
         }
-        else
+        for (; !has[slot]; slot++)
         {
-            root = root->left;
+            *p++ = 'N';
+            *p++ = ',';
         }
+        slot++;
+        p = to_chars(p, end, node->val).ptr;
+        *p++ = ',';
+        has.push_back(node->left != nullptr);
+        has.push_back(node->right != nullptr);
+        if (node->left)
+            order.push_back(node->left);
+        if (node->right)
+            order.push_back(node->right);
     }
-    return ans;
+    // nulls after the last value
+    size_t used = p - out.data();
+    out.resize(used + 2 * (has.size() - slot));
+    p = out.data() + used;
+    for (; slot < has.size(); slot++)
+    {
+        *p++ = 'N';
+        *p++ = ',';
+    }
+    out.pop_back(); // trailing comma
+    return out;
 }
-// Time  : O(h)
-// Space : O(1)
 
-// ! validate bst
-bool isValidBST(TreeNode *root)
+TreeNode *deserialize(string_view data, TreeArena *arena = nullptr)
 {
-    TreeNode *curr = root;
-    TreeNode *prev = nullptr;
-    bool res = true;
-    while (curr)
+    if (data.empty())
+        return nullptr;
+    CommaTokens tokens(data);
+    string_view tok;
+
+    // 1 = value, 0 = "N", -1 = malformed
+    auto parse = [](string_view tok, int &val)
     {
-        if (curr->left)
+        if (tok == "N")
+            return 0;
+        const char *last = tok.data() + tok.size();
+        auto [next, ec] = from_chars(tok.data(), last, val);
+        return ec == errc() && next == last ? 1 : -1;
+    };
+
+    int val;
+    if (!tokens.next(tok) || parse(tok, val) != 1)
+        return nullptr;
+    // BFS order, doubles as the queue. Full serialize() output has 2n + 1 tokens of
+    // >= 2 bytes with their commas, so n <= size / 4: no regrowth for it (input with
+    // trailing nulls left out may still grow the vector)
+    vector<TreeNode *> order;
+    order.reserve(data.size() / 4 + 1);
+    order.push_back(newNode(val, arena));
+    for (size_t head = 0; head < order.size(); head++)
+    {
+        TreeNode *node = order[head];
+        for (TreeNode **child : {&node->left, &node->right})
         {
-            TreeNode *pre = curr->left;
-            while (pre->right && pre->right != curr)
-            {
-                pre = pre->right;
-            }
-            if (pre->right == curr)
+            if (!tokens.next(tok))
+                return order[0]; // trailing nulls may be left out
+            int kind = parse(tok, val);
+            if (kind < 0)
             {
-                // in(curr)
-                if (prev && prev->val >= curr->val)
-                    res = false;
-                prev = curr;
-                pre->right = nullptr;
-                curr = curr->right;
+                if (!arena)
+                    freeTree(order[0]);
+                return nullptr;
             }
-            else
+            if (kind == 1)
             {
-                pre->right = curr;
-                curr = curr->left;
+                *child = newNode(val, arena);
+                order.push_back(*child);
             }
         }
-        else
-        {
-            // in(curr)
-            if (prev && prev->val >= curr->val)
-                res = false;
-            prev = curr;
-            curr = curr->right;
-        }
     }
-    return res;
+    return order[0];
 }
-// TC O(n)
-// SC O(1)
+// serialize   : O(n), O(log n) buffer growths
+// deserialize : O(bytes / 16) delimiter search + O(digits) parse, no per-token allocation
+// SC          : O(n) BFS order vector
 
-// ! insert in BST
-TreeNode *insertIntoBST(TreeNode *root, int val)
+// ! binary serialize deserialize bt
+/*
+Compact binary format, same level-order as serialize():
+
+    [varint n] [child bitmap: 2 bits per node] [n zigzag varints: values]
+
+- n = number of real nodes (length prefix, no "N" tokens at all)
+- bitmap bit 2i   = node i has a left child
+- bitmap bit 2i+1 = node i has a right child
+- values in level order, zigzag so small negatives stay 1 byte
+
+Level order means children of node i are simply the next unused ids,
+so decoding needs no parsing of tokens and no string per node.
+*/
+void putVarint(string &out, uint64_t x)
 {
-    if (!root)
-        return new TreeNode(val);
-    if (val > root->val)
-        root->right = insertIntoBST(root->right, val);
-    else
-        root->left = insertIntoBST(root->left, val);
-    return root;
-    // TreeNode *node,*prev;
-    // node = root;
-    // while(node){
-    //     prev=node;
-    //     if(node->val < val){
-    //         node=node->right;
-    //     }
-    //     else{
-    //         node=node->left;
-    //     }
-    // }
-    // if(val>prev->val) prev->right = new TreeNode(val);
-    // else prev->left = new TreeNode(val);
-    // return root;
+    while (x >= 0x80)
+    {
+        out.push_back(char(x | 0x80));
+        x >>= 7;
+    }
+    out.push_back(char(x));
 }
-// Time  : O(h)
-// Space : O(h) recursion stack
 
-// ! delete in BST
-TreeNode *deleteNode(TreeNode *root, int key)
+// returns false on truncated input
+bool getVarint(const uint8_t *&p, const uint8_t *end, uint64_t &x)
+{
+    x = 0;
+    for (int shift = 0; p < end && shift < 64; shift += 7)
+    {
+        uint8_t b = *p++;
+        x |= uint64_t(b & 0x7f) << shift;
+        if (!(b & 0x80))
+            return true;
+    }
+    return false;
+}
+
+uint32_t zigzag(int v) { return (uint32_t(v) << 1) ^ uint32_t(v >> 31); }
+int unzigzag(uint32_t u) { return int(u >> 1) ^ -int(u & 1); }
+
+string serializeBinary(TreeNode *root)
 {
+    string out;
     if (!root)
-        return nullptr;
+        return out;
 
-    // Step 1: search for the node
-    if (key < root->val)
+    // level order into a flat array (doubles as the BFS queue)
+    vector<TreeNode *> order;
+    order.push_back(root);
+    for (size_t i = 0; i < order.size(); i++)
     {
-        root->left = deleteNode(root->left, key);
+        if (order[i]->left)
+            order.push_back(order[i]->left);
+        if (order[i]->right)
+            order.push_back(order[i]->right);
     }
-    else if (key > root->val)
+
+    size_t n = order.size();
+    putVarint(out, n);
+
+    size_t bitmapAt = out.size();
+    out.resize(bitmapAt + (2 * n + 7) / 8, 0);
+    for (size_t i = 0; i < n; i++)
     {
-        root->right = deleteNode(root->right, key);
+        if (order[i]->left)
+            out[bitmapAt + (2 * i) / 8] |= char(1 << ((2 * i) % 8));
+        if (order[i]->right)
+            out[bitmapAt + (2 * i + 1) / 8] |= char(1 << ((2 * i + 1) % 8));
     }
-    else
+
+    out.reserve(out.size() + n * 2);
+    for (size_t i = 0; i < n; i++)
+        putVarint(out, zigzag(order[i]->val));
+    return out;
+}
+
+// returns nullptr for empty or malformed input (nodes already built are freed unless an arena owns them)
+TreeNode *deserializeBinary(const string &data, TreeArena *arena = nullptr)
+{
+    const uint8_t *p = reinterpret_cast<const uint8_t *>(data.data());
+    const uint8_t *end = p + data.size();
+
+    // every node takes at least one value byte, so a count past the remaining
+    // bytes is bogus; checking that first also keeps 2 * n from overflowing
+    uint64_t n;
+    if (!getVarint(p, end, n) || n == 0 || n > uint64_t(end - p) || uint64_t(end - p) < (2 * n + 7) / 8)
+        return nullptr;
+    const uint8_t *bitmap = p;
+    p += (2 * n + 7) / 8;
+
+    vector<TreeNode *> order(n);
+    size_t made = 0; // nodes created so far, also the id of the next child
+    auto nextNode = [&]() -> TreeNode *
     {
-        // -------- node found --------
+        uint64_t u;
+        if (made == n || !getVarint(p, end, u))
+            return nullptr;
+        return order[made++] = newNode(unzigzag(uint32_t(u)), arena);
+    };
 
-        // Case 1: leaf node
-        if (!root->left && !root->right)
+    if (!nextNode())
+        return nullptr;
+    for (size_t i = 0; i < made; i++)
+    {
+        bool ok = true;
+        if (bitmap[(2 * i) / 8] >> ((2 * i) % 8) & 1)
+            ok = (order[i]->left = nextNode()) != nullptr;
+        if (ok && bitmap[(2 * i + 1) / 8] >> ((2 * i + 1) % 8) & 1)
+            ok = (order[i]->right = nextNode()) != nullptr;
+        if (!ok)
         {
-            delete root;
+            if (!arena)
+                freeTree(order[0]); // every node made so far is linked under the root
             return nullptr;
         }
+    }
+    return order[0];
+}
+// Time  : O(n), one pass over the bytes
+// Space : O(n) id → node table, ~1-5 bytes per value + 2 bits per node on the wire
 
-        // Case 2: only right child
-        if (!root->left)
+// ! Streaming serialize / deserialize (fd or stream, bounded memory)
+/*
+serialize / deserialize need the whole text in one string. For files far
+bigger than the tree's widest level, stream instead:
+
+- StreamSource: refills a fixed chunk buffer from an fd (read) or an istream;
+  the tokenizer pulls bytes from it, so input memory is O(chunk)
+- decoding keeps only the nodes still waiting for children (the BFS
+  frontier) → O(width) + O(chunk), never the file
+- StreamSink: values go into a fixed buffer through to_chars, flushed with
+  write() / ostream::write when full, no per-value to_string temporaries
+- encoding keeps only non-null nodes in the queue and writes "N" for missing
+  children directly, so the queue is O(width) as well
+
+Same format as serialize ("1,2,N,3,..."), the two are interchangeable.
+Whitespace (e.g. a trailing newline) between tokens is ignored.
+Unlike deserialize, the stream decoder wants the COMPLETE token sequence
+(every node's two child tokens, trailing "N"s included, as serialize and
+serializeStream write it). End of input any earlier, or tokens left over
+after the last node, → nullptr: a file cut off mid-stream must not come
+back as a smaller, wrong tree.
+*/
+class StreamSource
+{
+    int fd = -1;
+    istream *in = nullptr;
+    vector<char> buf;
+    size_t pos = 0, len = 0;
+    bool failed = false, done = false; // done: EOF or error seen, don't read() again
+
+    bool refill()
+    {
+        pos = len = 0;
+        if (done)
+            return false;
+        if (in)
         {
-            TreeNode *temp = root->right;
-            delete root;
-            return temp;
+            in->read(buf.data(), buf.size());
+            len = in->gcount();
+            failed = in->bad();
         }
-
-        // Case 3: only left child
-        if (!root->right)
+        else
         {
-            TreeNode *temp = root->left;
-            delete root;
-            return temp;
+            ssize_t r;
+            do
+                r = read(fd, buf.data(), buf.size());
+            while (r < 0 && errno == EINTR);
+            failed = r < 0;
+            len = r > 0 ? r : 0;
         }
-        /*
-                !Method-1 Swap
-                root->val = suc->val;
-                root->right = deleteNode(root->right, suc->val);
+        done = len == 0 || failed;
+        return len > 0;
+    }
 
-                !Method-2 don't swap, attach root's left subtree to succ, increases height
-                suc->left = root->left;
-                return root->right;
-        */
-        // !Method-3
-        // ! detach the successor from its old parent, attach the root’s children to it
-        // Case 4: two children → use inorder successor
-        TreeNode *suc = root->right;
+public:
+    StreamSource(int fd, size_t chunk = 1 << 16) : fd(fd), buf(chunk) {}
+    StreamSource(istream &in, size_t chunk = 1 << 16) : in(&in), buf(chunk) {}
 
-        // If successor is immediate right child
-        if (!suc->left)
-        {
-            suc->left = root->left;
-            delete root;
-            return suc;
-        }
+    // next byte, -1 at end of input
+    int get()
+    {
+        if (pos == len && !refill())
+            return -1;
+        return (unsigned char)buf[pos++];
+    }
 
-        // Otherwise, find leftmost node in right subtree
-        TreeNode *parent = root;
-        while (suc->left)
-        {
-            parent = suc;
-            suc = suc->left;
-        }
+    bool error() const
+    {
+        return failed;
+    }
+};
 
-        // Detach successor from its old position
-        parent->left = suc->right;
+class StreamSink
+{
+    int fd = -1;
+    ostream *out = nullptr;
+    vector<char> buf;
+    size_t len = 0;
+    bool failed = false;
 
-        // Attach root's children to successor
-        suc->left = root->left;
-        suc->right = root->right;
+public:
+    StreamSink(int fd, size_t chunk = 1 << 16) : fd(fd), buf(chunk) {}
+    StreamSink(ostream &out, size_t chunk = 1 << 16) : out(&out), buf(chunk) {}
+    StreamSink(const StreamSink &) = delete;
+    StreamSink &operator=(const StreamSink &) = delete;
+    ~StreamSink()
+    {
+        flush();
+    }
 
-        delete root;
-        return suc;
+    bool flush()
+    {
+        if (out)
+            failed |= !out->write(buf.data(), len);
+        else
+            for (size_t done = 0; done < len && !failed;)
+            {
+                ssize_t w = write(fd, buf.data() + done, len - done);
+                if (w < 0 && errno != EINTR)
+                    failed = true;
+                else if (w > 0)
+                    done += w;
+            }
+        len = 0;
+        return !failed;
     }
 
-    return root;
+    void put(char c)
+    {
+        if (len == buf.size())
+            flush();
+        buf[len++] = c;
+    }
+
+    void putInt(int x)
+    {
+        if (buf.size() - len < 12) // "-2147483648" + 1
+            flush();
+        len = to_chars(buf.data() + len, buf.data() + buf.size(), x).ptr - buf.data();
+    }
+
+    bool ok() const
+    {
+        return !failed;
+    }
+};
+
+// one token: 1 = value in `val`, 0 = "N", -1 = end of input, -2 = malformed
+int readToken(StreamSource &src, int &val)
+{
+    int c = src.get();
+    while (c == ' ' || c == '\n' || c == '\r' || c == '\t')
+        c = src.get();
+    if (c == -1)
+        return -1;
+    int kind;
+    if (c == 'N')
+    {
+        kind = 0;
+        c = src.get();
+    }
+    else
+    {
+        bool neg = c == '-';
+        if (neg)
+            c = src.get();
+        if (c < '0' || c > '9')
+            return -2;
+        long long x = 0;
+        for (; c >= '0' && c <= '9'; c = src.get())
+        {
+            x = x * 10 + (c - '0');
+            if (x > (long long)INT_MAX + 1)
+                return -2;
+        }
+        x = neg ? -x : x;
+        if (x > INT_MAX)
+            return -2;
+        val = (int)x;
+        kind = 1;
+    }
+    while (c == ' ' || c == '\n' || c == '\r' || c == '\t')
+        c = src.get();
+    return (c == ',' || c == -1) ? kind : -2;
 }
-// Time  : O(h)
-// Space : O(h) recursion stack
 
-// ! LCA in BST
-TreeNode *lowestCommonAncestor(TreeNode *root, TreeNode *p, TreeNode *q)
+// nullptr on empty, malformed or truncated input (nodes already built are freed unless an arena owns them)
+TreeNode *deserializeStream(StreamSource &src, TreeArena *arena = nullptr)
 {
-    if (root->val < p->val && root->val < q->val)
-        return lowestCommonAncestor(root->right, p, q);
-    else if (root->val > p->val && root->val > q->val)
-        return lowestCommonAncestor(root->left, p, q);
+    int val;
+    int kind = readToken(src, val);
+    if (kind != 1)
+        return nullptr;
+    TreeNode *root = newNode(val, arena);
+    queue<TreeNode *> frontier; // nodes whose children haven't been read yet
+    frontier.push(root);
+    while (!frontier.empty())
+    {
+        TreeNode *node = frontier.front();
+        frontier.pop();
+        for (TreeNode **child : {&node->left, &node->right})
+        {
+            kind = readToken(src, val);
+            if (kind < 0) // malformed, or input ended before this child's token
+            {
+                if (!arena)
+                    freeTree(root);
+                return nullptr;
+            }
+            if (kind == 1)
+            {
+                *child = newNode(val, arena);
+                frontier.push(*child);
+            }
+        }
+    }
+    if (readToken(src, val) != -1 || src.error()) // tokens past the last node, or a read error
+    {
+        if (!arena)
+            freeTree(root);
+        return nullptr;
+    }
+    return root;
+}
+TreeNode *deserializeStream(int fd, TreeArena *arena = nullptr)
+{
+    StreamSource src(fd);
+    return deserializeStream(src, arena);
+}
+TreeNode *deserializeStream(istream &in, TreeArena *arena = nullptr)
+{
+    StreamSource src(in);
+    return deserializeStream(src, arena);
+}
+
+// same text as serialize(root); false if a write failed
+bool serializeStream(TreeNode *root, StreamSink &sink)
+{
+    if (!root)
+        return sink.flush();
+    queue<TreeNode *> frontier; // non-null nodes only
+    frontier.push(root);
+    sink.putInt(root->val);
+    while (!frontier.empty())
+    {
+        TreeNode *node = frontier.front();
+        frontier.pop();
+        for (TreeNode *child : {node->left, node->right})
+        {
+            sink.put(',');
+            if (child)
+            {
+                sink.putInt(child->val);
+                frontier.push(child);
+            }
+            else
+                sink.put('N');
+        }
+    }
+    return sink.flush();
+}
+bool serializeStream(TreeNode *root, int fd)
+{
+    StreamSink sink(fd);
+    return serializeStream(root, sink);
+}
+bool serializeStream(TreeNode *root, ostream &out)
+{
+    StreamSink sink(out);
+    return serializeStream(root, sink);
+}
+// Time  : O(n + bytes), one pass
+// Space : O(width) frontier + O(chunk) buffer, independent of file size
+
+//! BST search
+bool searchBST(TreeNode *root, int key)
+{
+    while (root)
+    {
+        if (root->val == key)
+            return true;
+        else if (key < root->val)
+            root = root->left;
+        else
+            root = root->right;
+    }
+    return false;
+}
+// Time  : O(h)
+// Space : O(1)
+//! BST floor/ceil
+int floorBST(TreeNode *root, int key)
+{
+    int ans = -1;
+
+    while (root)
+    {
+        if (root->val == key)
+            return key;
+
+        if (root->val < key)
+        {
+            ans = root->val; // possible floor, save when going right
+            root = root->right;
+        }
+        else
+        {
+            root = root->left;
+        }
+    }
+    return ans;
+}
+// Time  : O(h)
+// Space : O(1)
+
+// ! mmap tree snapshot (zero-copy, query in place)
+/*
+On-disk layout (native endian):
+
+    [SnapHeader][SnapRecord 0][SnapRecord 1] ... [SnapRecord n-1]
+
+- records are in level order, record 0 is the root
+- left/right are record indices, -1 = no child
+- a BST snapshot can be searched straight from the mapped pages,
+  nothing is parsed or copied when the file is opened
+- the file is not trusted: open() only checks the header and the exact
+  length, and each query step follows a child only if it points FORWARD
+  and inside the file (i < child < n), otherwise it counts as missing.
+  Every access stays in bounds and every walk ends (ids only grow), with
+  no O(n) pass before the first query. verify() is the opt-in full check
+  (exact level-order numbering, as writeSnapshot hands it out).
+*/
+struct SnapRecord
+{
+    int32_t val;
+    int32_t left;
+    int32_t right;
+};
+
+struct SnapHeader
+{
+    char magic[8]; // "TREESNP1"
+    uint64_t count;
+};
+
+const char SNAP_MAGIC[8] = {'T', 'R', 'E', 'E', 'S', 'N', 'P', '1'};
+
+// false on I/O error, or if the tree has more nodes than an int32_t id can number
+bool writeSnapshot(TreeNode *root, const char *path)
+{
+    // level order ids: a node's id is its position in the BFS queue
+    vector<TreeNode *> order;
+    if (root)
+        order.push_back(root);
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        if (order[i]->left)
+            order.push_back(order[i]->left);
+        if (order[i]->right)
+            order.push_back(order[i]->right);
+    }
+    if (order.size() > size_t(INT32_MAX))
+        return false;
+
+    FILE *f = fopen(path, "wb");
+    if (!f)
+        return false;
+
+    SnapHeader h;
+    memcpy(h.magic, SNAP_MAGIC, 8);
+    h.count = order.size();
+    bool ok = fwrite(&h, sizeof(h), 1, f) == 1;
+
+    int32_t next = 1; // id the next child will get
+    for (size_t i = 0; i < order.size() && ok; i++)
+    {
+        SnapRecord r{order[i]->val, -1, -1};
+        if (order[i]->left)
+            r.left = next++;
+        if (order[i]->right)
+            r.right = next++;
+        ok = fwrite(&r, sizeof(r), 1, f) == 1;
+    }
+    return fclose(f) == 0 && ok;
+}
+// Time  : O(n)
+// Space : O(n) BFS order
+
+class TreeSnapshot
+{
+    void *base = MAP_FAILED;
+    size_t len = 0;
+    const SnapRecord *rec = nullptr;
+    size_t n = 0;
+
+    // ids only grow along an edge, so following forward links always ends
+    int forward(int i, int32_t child) const { return child > i && size_t(child) < n ? child : -1; }
+
+public:
+    TreeSnapshot() {}
+    TreeSnapshot(const TreeSnapshot &) = delete;
+    TreeSnapshot &operator=(const TreeSnapshot &) = delete;
+    ~TreeSnapshot() { close(); }
+
+    // maps the file read-only; pages are faulted in lazily on first touch
+    bool open(const char *path)
+    {
+        close();
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(SnapHeader))
+        {
+            ::close(fd);
+            return false;
+        }
+        len = st.st_size;
+        base = mmap(nullptr, len, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd); // the mapping keeps the file alive
+        if (base == MAP_FAILED)
+            return false;
+
+        const SnapHeader *h = static_cast<const SnapHeader *>(base);
+        size_t body = len - sizeof(SnapHeader);
+        if (memcmp(h->magic, SNAP_MAGIC, 8) != 0 || body % sizeof(SnapRecord) != 0 ||
+            h->count != body / sizeof(SnapRecord))
+        {
+            close();
+            return false;
+        }
+        n = h->count;
+        rec = reinterpret_cast<const SnapRecord *>(h + 1);
+        return true;
+    }
+
+    // opt-in full check, one sequential pass over every record (pages the whole file in):
+    // children must be numbered exactly like writeSnapshot does it
+    bool verify() const
+    {
+        if (n > size_t(INT32_MAX))
+            return false;
+        int64_t next = 1;
+        for (size_t i = 0; i < n; i++)
+        {
+            for (int32_t child : {rec[i].left, rec[i].right})
+                if (child != -1 && child != next++)
+                    return false;
+        }
+        return next == int64_t(n) || n == 0;
+    }
+
+    void close()
+    {
+        if (base != MAP_FAILED)
+            munmap(base, len);
+        base = MAP_FAILED;
+        len = 0;
+        rec = nullptr;
+        n = 0;
+    }
+
+    size_t size() const { return n; }
+    int root() const { return n ? 0 : -1; }
+    const SnapRecord &operator[](int i) const { return rec[i]; }
+    // child links of record i, -1 if missing or not pointing forward inside the file
+    int left(int i) const { return forward(i, rec[i].left); }
+    int right(int i) const { return forward(i, rec[i].right); }
+};
+
+bool searchBST(const TreeSnapshot &t, int key)
+{
+    int i = t.root();
+    while (i != -1)
+    {
+        if (t[i].val == key)
+            return true;
+        i = key < t[i].val ? t.left(i) : t.right(i);
+    }
+    return false;
+}
+
+int floorBST(const TreeSnapshot &t, int key)
+{
+    int ans = -1;
+    int i = t.root();
+    while (i != -1)
+    {
+        if (t[i].val == key)
+            return key;
+        if (t[i].val < key)
+        {
+            ans = t[i].val;
+            i = t.right(i);
+        }
+        else
+            i = t.left(i);
+    }
+    return ans;
+}
+// Time  : O(h) page touches, Space : O(1)
+
+// Records are already in level order, so every level is a contiguous run
+// [start, end) and the next run ends after all children of this one:
+// BFS becomes a sequential scan with no queue. Only in-bounds forward
+// children are counted and a run never goes past n, so a bad file
+// can give odd levels but never an out-of-bounds read.
+vector<vector<int>> levelOrder(const TreeSnapshot &t)
+{
+    vector<vector<int>> res;
+    size_t start = 0, end = t.size() ? 1 : 0;
+    while (start < end)
+    {
+        vector<int> level;
+        size_t next = end;
+        for (size_t i = start; i < end; i++)
+        {
+            level.push_back(t[i].val);
+            next += (t.left(i) != -1) + (t.right(i) != -1);
+        }
+        res.push_back(level);
+        start = end;
+        end = min(next, t.size());
+    }
+    return res;
+}
+
+int maxDepth(const TreeSnapshot &t)
+{
+    int depth = 0;
+    size_t start = 0, end = t.size() ? 1 : 0;
+    while (start < end)
+    {
+        size_t next = end;
+        for (size_t i = start; i < end; i++)
+            next += (t.left(i) != -1) + (t.right(i) != -1);
+        depth++;
+        start = end;
+        end = min(next, t.size());
+    }
+    return depth;
+}
+// Time  : O(n) sequential read of the mapping
+// Space : O(1) extra (besides the output for levelOrder), no recursion
+
+// ! validate bst
+bool isValidBST(TreeNode *root)
+{
+    TreeNode *curr = root;
+    TreeNode *prev = nullptr;
+    bool res = true;
+    while (curr)
+    {
+        if (curr->left)
+        {
+            TreeNode *pre = curr->left;
+            while (pre->right && pre->right != curr)
+            {
+                pre = pre->right;
+            }
+            if (pre->right == curr)
+            {
+                // in(curr)
+                if (prev && prev->val >= curr->val)
+                    res = false;
+                prev = curr;
+                pre->right = nullptr;
+                curr = curr->right;
+            }
+            else
+            {
+                pre->right = curr;
+                curr = curr->left;
+            }
+        }
+        else
+        {
+            // in(curr)
+            if (prev && prev->val >= curr->val)
+                res = false;
+            prev = curr;
+            curr = curr->right;
+        }
+    }
+    return res;
+}
+// TC O(n)
+// SC O(1)
+
+// ! Parallel fork-join tree reductions
+/*
+maxDepth, diameter (height), maxPathSum (sum) and isValidBST are all reductions:
+answer(node) = combine(answer(left), answer(right), node).
+So the two subtrees can be solved at the same time:
+- near the root, hand the left subtree to another thread (std::async) and do the
+  right subtree on this one, then join
+- below FORK depth, just call the existing serial function on the subtree
+FORK = log2(threads) + 2 gives ~4 tasks per thread, so one unlucky big subtree
+doesn't leave the other cores idle for long.
+*/
+int forkDepth(int threads)
+{
+    int d = 2;
+    while ((1 << (d - 2)) < threads)
+        d++;
+    return threads <= 1 ? 0 : d;
+}
+
+// runs left(), right() in parallel when depth allows and both sides have work
+template <class L, class R>
+auto forkJoin(TreeNode *node, int depth, int fork, L left, R right)
+{
+    if (depth < fork && node->left && node->right)
+    {
+        auto fut = async(launch::async, left);
+        auto r = right();
+        return make_pair(fut.get(), r);
+    }
+    auto l = left();
+    return make_pair(l, right());
+}
+
+int maxDepthPar(TreeNode *node, int depth, int fork)
+{
+    if (!node || depth >= fork)
+        return maxDepth(node);
+    auto [lh, rh] = forkJoin(node, depth, fork,
+                             [=] { return maxDepthPar(node->left, depth + 1, fork); },
+                             [=] { return maxDepthPar(node->right, depth + 1, fork); });
+    return 1 + max(lh, rh);
+}
+int maxDepthParallel(TreeNode *root, int threads = thread::hardware_concurrency())
+{
+    return maxDepthPar(root, 0, forkDepth(threads));
+}
+
+// {height, best diameter inside}
+pair<int, int> diameterPar(TreeNode *node, int depth, int fork)
+{
+    if (!node || depth >= fork)
+    {
+        int w = 0;
+        int h = height(node, w);
+        return {h, w};
+    }
+    auto [l, r] = forkJoin(node, depth, fork,
+                           [=] { return diameterPar(node->left, depth + 1, fork); },
+                           [=] { return diameterPar(node->right, depth + 1, fork); });
+    int best = max({l.second, r.second, l.first + r.first});
+    return {1 + max(l.first, r.first), best};
+}
+int diameterOfBinaryTreeParallel(TreeNode *root, int threads = thread::hardware_concurrency())
+{
+    return diameterPar(root, 0, forkDepth(threads)).second;
+}
+
+// {best downward gain, best path inside}
+pair<int, int> pathSumPar(TreeNode *node, int depth, int fork)
+{
+    if (!node || depth >= fork)
+    {
+        int best = INT_MIN;
+        int gain = sum(node, best);
+        return {gain, best};
+    }
+    auto [l, r] = forkJoin(node, depth, fork,
+                           [=] { return pathSumPar(node->left, depth + 1, fork); },
+                           [=] { return pathSumPar(node->right, depth + 1, fork); });
+    int best = max({l.second, r.second, l.first + r.first + node->val});
+    return {max(max(l.first, r.first) + node->val, 0), best};
+}
+int maxPathSumParallel(TreeNode *root, int threads = thread::hardware_concurrency())
+{
+    return pathSumPar(root, 0, forkDepth(threads)).second;
+}
+
+// every key of the subtree must lie strictly inside (lo, hi).
+// Below the fork depth: the serial Morris isValidBST checks the subtree itself
+// (threads only rethread nodes of their own subtree, so this is safe) and the
+// leftmost/rightmost nodes check the bounds.
+bool validPar(TreeNode *node, long long lo, long long hi, int depth, int fork)
+{
+    if (!node)
+        return true;
+    if (node->val <= lo || node->val >= hi)
+        return false;
+    if (depth >= fork)
+    {
+        TreeNode *mn = node, *mx = node;
+        while (mn->left)
+            mn = mn->left;
+        while (mx->right)
+            mx = mx->right;
+        return mn->val > lo && mx->val < hi && isValidBST(node);
+    }
+    auto [l, r] = forkJoin(node, depth, fork,
+                           [=] { return validPar(node->left, lo, node->val, depth + 1, fork); },
+                           [=] { return validPar(node->right, node->val, hi, depth + 1, fork); });
+    return l && r;
+}
+bool isValidBSTParallel(TreeNode *root, int threads = thread::hardware_concurrency())
+{
+    return validPar(root, LLONG_MIN, LLONG_MAX, 0, forkDepth(threads));
+}
+// Work  : O(n), same as serial
+// Span  : O(n / threads) for balanced trees; a skewed tree has nothing to fork and runs serially
+// Space : O(h) per task, plus O(2^FORK) small task frames
+
+// ! insert in BST
+TreeNode *insertIntoBST(TreeNode *root, int val, TreeArena *arena = nullptr)
+{
+    if (!root)
+        return newNode(val, arena);
+    if (val > root->val)
+        root->right = insertIntoBST(root->right, val, arena);
+    else
+        root->left = insertIntoBST(root->left, val, arena);
+    return root;
+    // TreeNode *node,*prev;
+    // node = root;
+    // while(node){
+    //     prev=node;
+    //     if(node->val < val){
+    //         node=node->right;
+    //     }
+    //     else{
+    //         node=node->left;
+    //     }
+    // }
+    // if(val>prev->val) prev->right = new TreeNode(val);
+    // else prev->left = new TreeNode(val);
+    // return root;
+}
+// Time  : O(h)
+// Space : O(h) recursion stack
+
+// ! delete in BST
+TreeNode *deleteNode(TreeNode *root, int key, TreeArena *arena = nullptr)
+{
+    if (!root)
+        return nullptr;
+
+    // Step 1: search for the node
+    if (key < root->val)
+    {
+        root->left = deleteNode(root->left, key, arena);
+    }
+    else if (key > root->val)
+    {
+        root->right = deleteNode(root->right, key, arena);
+    }
+    else
+    {
+        // -------- node found --------
+
+        // Case 1: leaf node
+        if (!root->left && !root->right)
+        {
+            dropNode(root, arena);
+            return nullptr;
+        }
+
+        // Case 2: only right child
+        if (!root->left)
+        {
+            TreeNode *temp = root->right;
+            dropNode(root, arena);
+            return temp;
+        }
+
+        // Case 3: only left child
+        if (!root->right)
+        {
+            TreeNode *temp = root->left;
+            dropNode(root, arena);
+            return temp;
+        }
+        /*
+                !Method-1 Swap
+                root->val = suc->val;
+                root->right = deleteNode(root->right, suc->val);
+
+                !Method-2 don't swap, attach root's left subtree to succ, increases height
+                suc->left = root->left;
+                return root->right;
+        */
+        // !Method-3
+        // ! detach the successor from its old parent, attach the root’s children to it
+        // Case 4: two children → use inorder successor
+        TreeNode *suc = root->right;
+
+        // If successor is immediate right child
+        if (!suc->left)
+        {
+            suc->left = root->left;
+            dropNode(root, arena);
+            return suc;
+        }
+
+        // Otherwise, find leftmost node in right subtree
+        TreeNode *parent = root;
+        while (suc->left)
+        {
+            parent = suc;
+            suc = suc->left;
+        }
+
+        // Detach successor from its old position
+        parent->left = suc->right;
+
+        // Attach root's children to successor
+        suc->left = root->left;
+        suc->right = root->right;
+
+        dropNode(root, arena);
+        return suc;
+    }
+
+    return root;
+}
+// Time  : O(h)
+// Space : O(h) recursion stack
+
+// ! Self-balancing BST (scapegoat tree)
+/*
+insertIntoBST/deleteNode never rebalance: increasing keys turn the tree into a list.
+
+A scapegoat tree keeps plain TreeNodes (no extra fields), so searchBST, floorBST,
+BSTIterator and everything else in this file works on it unchanged:
+- insert as usual; if the new node ends up deeper than log_{3/2}(n), walk back up
+  to the first ancestor whose child holds > 2/3 of its nodes (the "scapegoat")
+  and rebuild that subtree perfectly balanced (same midpoint split as buildBST)
+- delete as usual; once n drops below 2/3 of the max size since the last full
+  rebuild, rebuild the whole tree
+Rebuilds relink the existing nodes, nothing is reallocated.
+*/
+class BalancedBST
+{
+    TreeNode *root = nullptr;
+    size_t n = 0, maxN = 0;
+    TreeArena *arena;
+    // scratch buffers reused across calls, so inserts don't hit malloc
+    vector<TreeNode *> path, st, nodes;
+
+    size_t countNodes(TreeNode *node)
+    {
+        size_t cnt = 0;
+        st.clear();
+        if (node)
+            st.push_back(node);
+        while (!st.empty())
+        {
+            TreeNode *cur = st.back();
+            st.pop_back();
+            cnt++;
+            if (cur->left)
+                st.push_back(cur->left);
+            if (cur->right)
+                st.push_back(cur->right);
+        }
+        return cnt;
+    }
+
+    TreeNode *relink(int i, int j)
+    {
+        if (i > j)
+            return nullptr;
+        int mid = i + (j - i + 1) / 2;
+        TreeNode *node = nodes[mid];
+        node->left = relink(i, mid - 1);
+        node->right = relink(mid + 1, j);
+        return node;
+    }
+
+    // flatten in-order and relink as a perfectly balanced subtree
+    TreeNode *rebuild(TreeNode *node)
+    {
+        nodes.clear();
+        st.clear();
+        while (node || !st.empty())
+        {
+            while (node)
+            {
+                st.push_back(node);
+                node = node->left;
+            }
+            node = st.back();
+            st.pop_back();
+            nodes.push_back(node);
+            node = node->right;
+        }
+        return relink(0, (int)nodes.size() - 1);
+    }
+
+    // deepest allowed depth (edges) for n nodes: floor(log_{3/2} n)
+    static size_t depthLimit(size_t n)
+    {
+        return size_t(log((double)n) / log(1.5));
+    }
+
+public:
+    BalancedBST(TreeArena *arena = nullptr) : arena(arena) {}
+    BalancedBST(const BalancedBST &) = delete;
+    BalancedBST &operator=(const BalancedBST &) = delete;
+    ~BalancedBST()
+    {
+        if (!arena)
+            freeTree(root);
+    }
+
+    TreeNode *getRoot() const { return root; }
+    size_t size() const { return n; }
+
+    void insert(int val)
+    {
+        TreeNode *node = newNode(val, arena);
+        n++;
+        maxN = max(maxN, n);
+        if (!root)
+        {
+            root = node;
+            return;
+        }
+
+        // same placement rule as insertIntoBST: bigger goes right, equal goes left
+        path.clear();
+        TreeNode *cur = root;
+        while (cur)
+        {
+            path.push_back(cur);
+            cur = val > cur->val ? cur->right : cur->left;
+        }
+        (val > path.back()->val ? path.back()->right : path.back()->left) = node;
+
+        if (path.size() <= depthLimit(n))
+            return;
+
+        // climb until a child holds more than 2/3 of its parent's subtree
+        TreeNode *child = node;
+        size_t childSize = 1;
+        for (int i = (int)path.size() - 1; i >= 0; i--)
+        {
+            TreeNode *parent = path[i];
+            TreeNode *sibling = parent->left == child ? parent->right : parent->left;
+            size_t parentSize = childSize + countNodes(sibling) + 1;
+            if (3 * childSize > 2 * parentSize)
+            {
+                TreeNode *sub = rebuild(parent);
+                if (i == 0)
+                    root = sub;
+                else if (path[i - 1]->left == parent)
+                    path[i - 1]->left = sub;
+                else
+                    path[i - 1]->right = sub;
+                return;
+            }
+            child = parent;
+            childSize = parentSize;
+        }
+    }
+
+    // returns false if key was not in the tree
+    bool erase(int key)
+    {
+        if (!searchBST(root, key))
+            return false;
+        root = deleteNode(root, key, arena);
+        n--;
+        if (3 * n < 2 * maxN)
+        {
+            root = rebuild(root);
+            maxN = n;
+        }
+        return true;
+    }
+};
+// insert : O(log n) amortized (rebuilding a subtree of size s costs O(s), paid for by
+//          the Ω(s) inserts that unbalanced it)
+// erase  : O(log n) amortized
+// height : ≤ log_{3/2} n + 1 ≈ 1.71·log₂ n at all times, even for sorted input
+// SC     : no per-node overhead, O(log n) path + O(s) during a rebuild
+
+// same surface as the plain BST functions
+TreeNode *insertIntoBST(BalancedBST &t, int val)
+{
+    t.insert(val);
+    return t.getRoot();
+}
+TreeNode *deleteNode(BalancedBST &t, int key)
+{
+    t.erase(key);
+    return t.getRoot();
+}
+bool searchBST(const BalancedBST &t, int key)
+{
+    return searchBST(t.getRoot(), key);
+}
+int floorBST(const BalancedBST &t, int key)
+{
+    return floorBST(t.getRoot(), key);
+}
+// BSTIterator it(t.getRoot()); works as is
+
+// ! Concurrent BST: lock-free readers, one writer at a time
+/*
+Readers never lock: every child link is an atomic pointer, and a writer only
+changes the tree by swinging ONE link to a fully built node/subtree, so a reader
+always sees either the old or the new shape, never a half-made one.
+
+- insert: hang a new leaf (one link store)
+- delete 0/1 child: parent link → the child
+- delete 2 children: build a COPY of the successor that takes over the
+  node's children. If the successor sits deeper than node->right, the path
+  node->right .. successor's parent is copied too (the parent copy drops the
+  successor), so the copy hangs over a fresh right subtree. Then ONE store
+  on the parent link publishes it all. Nodes that readers can still see are
+  never modified in place; a second store (unlinking the old successor
+  separately) would let a reader paused inside the old right subtree walk
+  into the new shape and miss keys.
+
+Unlinked nodes can't be freed right away (a reader may be standing on one).
+Epoch-based reclamation:
+- a reader publishes the global epoch in its slot for the duration of one op
+- the writer stamps each unlinked node with the current epoch and bumps it
+- a node stamped r is freed once every active reader slot shows an epoch > r
+  (those readers started after the unlink, so they can't reach it)
+Writers are serialized by a mutex.
+*/
+struct CNode
+{
+    int val;
+    atomic<CNode *> left, right;
+    CNode(int x) : val(x), left(nullptr), right(nullptr) {}
+};
+
+class ConcurrentBST
+{
+    static const int MAX_READERS = 128;
+    struct alignas(64) Slot // one cache line each, readers don't false-share
+    {
+        atomic<uint64_t> epoch{0}; // 0 = not inside an operation
+        atomic<bool> taken{false};
+    };
+
+    atomic<CNode *> root{nullptr};
+    atomic<uint64_t> globalEpoch{1};
+    Slot slots[MAX_READERS];
+    mutex writeMu;
+    vector<pair<uint64_t, CNode *>> retired; // guarded by writeMu
+
+    void retire(CNode *node)
+    {
+        retired.push_back({globalEpoch.fetch_add(1), node});
+        if (retired.size() >= 64)
+            reclaim();
+    }
+
+    void reclaim()
+    {
+        // unlink stores must be visible before we look at reader slots
+        atomic_thread_fence(memory_order_seq_cst);
+        uint64_t oldest = UINT64_MAX;
+        for (Slot &s : slots)
+        {
+            uint64_t e = s.epoch.load();
+            if (e)
+                oldest = min(oldest, e);
+        }
+        size_t kept = 0;
+        for (auto &[stamp, node] : retired)
+        {
+            if (stamp < oldest)
+                delete node;
+            else
+                retired[kept++] = {stamp, node};
+        }
+        retired.resize(kept);
+    }
+
+public:
+    ConcurrentBST() {}
+    ConcurrentBST(const ConcurrentBST &) = delete;
+    ConcurrentBST &operator=(const ConcurrentBST &) = delete;
+    ~ConcurrentBST()
+    {
+        for (auto &r : retired)
+            delete r.second;
+        stack<CNode *> st;
+        if (root.load())
+            st.push(root.load());
+        while (!st.empty())
+        {
+            CNode *node = st.top();
+            st.pop();
+            if (node->left.load())
+                st.push(node->left.load());
+            if (node->right.load())
+                st.push(node->right.load());
+            delete node;
+        }
+    }
+
+    // one per reading thread; claims an epoch slot for its lifetime
+    class Reader
+    {
+        ConcurrentBST &t;
+        Slot *slot = nullptr;
+
+        struct Pin // epoch pinned for one operation
+        {
+            Slot *s;
+            Pin(ConcurrentBST &t, Slot *s) : s(s)
+            {
+                s->epoch.store(t.globalEpoch.load());
+                atomic_thread_fence(memory_order_seq_cst); // publish before reading the tree
+            }
+            ~Pin() { s->epoch.store(0, memory_order_release); }
+        };
+
+    public:
+        Reader(ConcurrentBST &t) : t(t)
+        {
+            for (Slot &s : t.slots)
+            {
+                bool expected = false;
+                if (s.taken.compare_exchange_strong(expected, true))
+                {
+                    slot = &s;
+                    return;
+                }
+            }
+            // out of slots: fail loudly rather than read unprotected
+            cerr << "ConcurrentBST: more than " << MAX_READERS << " readers\n";
+            abort();
+        }
+        Reader(const Reader &) = delete;
+        ~Reader() { slot->taken.store(false); }
+
+        bool search(int key)
+        {
+            Pin pin(t, slot);
+            CNode *node = t.root.load(memory_order_acquire);
+            while (node)
+            {
+                if (node->val == key)
+                    return true;
+                node = (key < node->val ? node->left : node->right).load(memory_order_acquire);
+            }
+            return false;
+        }
+
+        int floor(int key)
+        {
+            Pin pin(t, slot);
+            int ans = -1;
+            CNode *node = t.root.load(memory_order_acquire);
+            while (node)
+            {
+                if (node->val == key)
+                    return key;
+                if (node->val < key)
+                {
+                    ans = node->val;
+                    node = node->right.load(memory_order_acquire);
+                }
+                else
+                    node = node->left.load(memory_order_acquire);
+            }
+            return ans;
+        }
+    };
+
+    // same placement rule as insertIntoBST: bigger goes right, equal goes left
+    void insert(int val)
+    {
+        lock_guard<mutex> lock(writeMu);
+        atomic<CNode *> *link = &root;
+        while (CNode *node = link->load(memory_order_relaxed))
+            link = val > node->val ? &node->right : &node->left;
+        link->store(new CNode(val), memory_order_release);
+    }
+
+    // returns false if key was not in the tree
+    bool erase(int key)
+    {
+        lock_guard<mutex> lock(writeMu);
+        atomic<CNode *> *link = &root;
+        CNode *node = root.load(memory_order_relaxed);
+        while (node && node->val != key)
+        {
+            link = key < node->val ? &node->left : &node->right;
+            node = link->load(memory_order_relaxed);
+        }
+        if (!node)
+            return false;
+
+        CNode *l = node->left.load(memory_order_relaxed);
+        CNode *r = node->right.load(memory_order_relaxed);
+        if (!l || !r)
+        {
+            link->store(l ? l : r, memory_order_release);
+            retire(node);
+            return true;
+        }
+
+        // two children: successor = leftmost of right subtree
+        CNode *suc = r;
+        while (CNode *next = suc->left.load(memory_order_relaxed))
+            suc = next;
+        CNode *copy = new CNode(suc->val);
+        copy->left.store(l, memory_order_relaxed);
+        vector<CNode *> path;
+        if (suc == r)
+            copy->right.store(suc->right.load(memory_order_relaxed), memory_order_relaxed);
+        else
+        {
+            // path-copy r .. successor's parent, none of it visible until the swing
+            atomic<CNode *> *to = &copy->right;
+            for (CNode *p = r; p != suc; p = p->left.load(memory_order_relaxed))
+            {
+                path.push_back(p);
+                CNode *c = new CNode(p->val);
+                c->right.store(p->right.load(memory_order_relaxed), memory_order_relaxed);
+                to->store(c, memory_order_relaxed);
+                to = &c->left;
+            }
+            to->store(suc->right.load(memory_order_relaxed), memory_order_relaxed);
+        }
+        link->store(copy, memory_order_release); // one swing: old shape or new, nothing between
+        retire(node);
+        for (CNode *p : path) // retire may free, so don't walk the old links here
+            retire(p);
+        retire(suc);
+        return true;
+    }
+};
+// search / floor : O(h), wait-free for readers (no locks, no retries, no CAS)
+// insert / erase : O(h) under the writer mutex (erase copies at most h nodes)
+// Memory         : unlinked nodes wait in `retired` until no reader can still hold them
+
+// ! Augmented BST: subtree size / sum / min / max
+/*
+Every node caches aggregates of its whole subtree:
+    size = 1 + size(L) + size(R)
+    sum  = val + sum(L) + sum(R)
+    mn / mx = smallest / largest key in the subtree
+insert/delete only change nodes on one root-to-leaf path, and each of those is
+recomputed (pull) on the way back up, so the aggregates stay exact.
+
+That turns whole-tree scans into one root-to-leaf walk:
+- kthSmallest(k): go left if size(L) >= k, else skip size(L) + 1 and go right
+- rankBST(key)  : number of keys < key, add size(L) + 1 whenever we go right
+- rangeSum(lo, hi) = (sum of keys <= hi) - (sum of keys < lo)
+
+To keep the walks O(log n) the tree is weight balanced: if one child holds more
+than 3/4 of a subtree after an update, that subtree is rebuilt perfectly
+balanced (sizes are already cached, so the check is free).
+*/
+struct AugNode
+{
+    int val;
+    AugNode *left, *right;
+    int size;
+    long long sum;
+    int mn, mx;
+    AugNode(int x) : val(x), left(nullptr), right(nullptr), size(1), sum(x), mn(x), mx(x) {}
+};
+
+int sizeOf(AugNode *node) { return node ? node->size : 0; }
+long long sumOf(AugNode *node) { return node ? node->sum : 0; }
+
+// recompute node's aggregates from its children
+void pull(AugNode *node)
+{
+    node->size = 1 + sizeOf(node->left) + sizeOf(node->right);
+    node->sum = node->val + sumOf(node->left) + sumOf(node->right);
+    node->mn = node->left ? node->left->mn : node->val;
+    node->mx = node->right ? node->right->mx : node->val;
+}
+
+void collect(AugNode *node, vector<AugNode *> &nodes)
+{
+    if (!node)
+        return;
+    collect(node->left, nodes);
+    nodes.push_back(node);
+    collect(node->right, nodes);
+}
+
+AugNode *relink(vector<AugNode *> &nodes, int i, int j)
+{
+    if (i > j)
+        return nullptr;
+    int mid = i + (j - i + 1) / 2;
+    AugNode *node = nodes[mid];
+    node->left = relink(nodes, i, mid - 1);
+    node->right = relink(nodes, mid + 1, j);
+    pull(node);
+    return node;
+}
+
+// rebuild the subtree if one side got heavier than 3/4 of it
+AugNode *balance(AugNode *node)
+{
+    if (node->size < 4 || 4 * max(sizeOf(node->left), sizeOf(node->right)) <= 3 * node->size)
+        return node;
+    vector<AugNode *> nodes;
+    collect(node, nodes);
+    return relink(nodes, 0, (int)nodes.size() - 1);
+}
+
+// same placement rule as insertIntoBST: bigger goes right, equal goes left
+AugNode *insertIntoBST(AugNode *root, int val)
+{
+    if (!root)
+        return new AugNode(val);
+    if (val > root->val)
+        root->right = insertIntoBST(root->right, val);
+    else
+        root->left = insertIntoBST(root->left, val);
+    pull(root);
+    return balance(root);
+}
+
+AugNode *deleteNode(AugNode *root, int key)
+{
+    if (!root)
+        return nullptr;
+    if (key < root->val)
+        root->left = deleteNode(root->left, key);
+    else if (key > root->val)
+        root->right = deleteNode(root->right, key);
+    else
+    {
+        if (!root->left || !root->right)
+        {
+            AugNode *child = root->left ? root->left : root->right;
+            delete root;
+            return child;
+        }
+        // Method-1 swap: take the successor's value, then delete the successor
+        // (keeps every changed node on one path, so pull() fixes them all)
+        root->val = root->right->mn;
+        root->right = deleteNode(root->right, root->val);
+    }
+    pull(root);
+    return balance(root);
+}
+
+// k is 1-based; -1 if k is out of range
+int kthSmallest(AugNode *root, int k)
+{
+    while (root)
+    {
+        int ls = sizeOf(root->left);
+        if (k <= ls)
+            root = root->left;
+        else if (k == ls + 1)
+            return root->val;
+        else
+        {
+            k -= ls + 1;
+            root = root->right;
+        }
+    }
+    return -1;
+}
+
+// number of keys < key
+int rankBST(AugNode *root, int key)
+{
+    int r = 0;
+    while (root)
+    {
+        if (root->val < key)
+        {
+            r += sizeOf(root->left) + 1;
+            root = root->right;
+        }
+        else
+            root = root->left;
+    }
+    return r;
+}
+
+// sum of keys < key (orEqual: <= key)
+long long prefixSum(AugNode *root, int key, bool orEqual)
+{
+    long long s = 0;
+    while (root)
+    {
+        if (root->val < key || (orEqual && root->val == key))
+        {
+            s += sumOf(root->left) + root->val;
+            root = root->right;
+        }
+        else
+            root = root->left;
+    }
+    return s;
+}
+
+// sum of keys in [lo, hi]
+long long rangeSum(AugNode *root, int lo, int hi)
+{
+    if (lo > hi)
+        return 0;
+    return prefixSum(root, hi, true) - prefixSum(root, lo, false);
+}
+// insert / delete : O(log n) amortized (height ≤ log_{4/3} n, rebuilds amortize like a scapegoat tree)
+// kthSmallest / rankBST / rangeSum : O(log n), no scan
+// min / max of any subtree : O(1) (node->mn, node->mx)
+// SC : 16 extra bytes per node
+
+// ! Persistent (copy-on-write) BST: snapshots for long readers
+/*
+Nodes are never modified after they are built. An update copies only the
+nodes on the root → target path and points the copies at the untouched
+subtrees of the old version:
+
+        old:  5            new (insert 7):  5'
+             / \                           / \
+            3   8                         3   8'
+                                              /
+                                             7
+  3 is shared by both versions. Every version is a full, consistent tree.
+
+- a version is just a root pointer (PTree = shared_ptr to a const node)
+- nodes are reference counted: a node goes away when the last version that
+  reaches it is released, so an old snapshot stays readable as long as
+  someone holds it, with no epochs and no locks on the read path
+- PersistentBST keeps the latest version; writers are serialized, and the
+  head pointer is swapped under a tiny lock (a shared_ptr copy isn't atomic)
+
+Weight-balanced (BB[alpha], delta = 3, gamma = 2 on weight = size + 1):
+every node stores its subtree size, and on the way back up a copied node
+whose sides differ by more than 3x is rebuilt with a single or double
+rotation. Rotations only touch nodes that are being copied anyway, so an
+update is still one path of new nodes, and the height stays
+< 2.5 log2(n) even for monotonic keys. That bounds the copy cost, the
+recursion depth of insert / erase, and the depth of the recursive
+shared_ptr teardown when a version is dropped.
+
+Duplicates are kept (multiset, like insertIntoBST). Rotations keep the
+inorder sequence, so equal keys may sit on either side of each other;
+search / floor / erase only rely on the inorder being sorted.
+*/
+struct PNode;
+using PTree = shared_ptr<const PNode>;
+
+struct PNode
+{
+    int val;
+    int size; // nodes in this subtree
+    PTree left, right;
+    PNode(int x, PTree l, PTree r) : val(x), size(1 + (l ? l->size : 0) + (r ? r->size : 0)),
+                                     left(std::move(l)), right(std::move(r)) {}
+};
+
+int weightP(const PTree &t) { return (t ? t->size : 0) + 1; }
+
+PTree makeP(int val, PTree l, PTree r) { return make_shared<const PNode>(val, std::move(l), std::move(r)); }
+
+// node (val, l, r) where one side may be off by one insert / erase
+PTree balanceP(int val, PTree l, PTree r)
+{
+    int wl = weightP(l), wr = weightP(r);
+    if (wr > 3 * wl) // right heavy: rotate left
+    {
+        if (weightP(r->left) < 2 * weightP(r->right))
+            return makeP(r->val, makeP(val, std::move(l), r->left), r->right);
+        const PNode *rl = r->left.get();
+        return makeP(rl->val, makeP(val, std::move(l), rl->left), makeP(r->val, rl->right, r->right));
+    }
+    if (wl > 3 * wr) // left heavy: rotate right
+    {
+        if (weightP(l->right) < 2 * weightP(l->left))
+            return makeP(l->val, l->left, makeP(val, l->right, std::move(r)));
+        const PNode *lr = l->right.get();
+        return makeP(lr->val, makeP(l->val, l->left, lr->left), makeP(val, lr->right, std::move(r)));
+    }
+    return makeP(val, std::move(l), std::move(r));
+}
+
+PTree insertPersistent(const PTree &root, int val)
+{
+    if (!root)
+        return makeP(val, nullptr, nullptr);
+    if (val > root->val)
+        return balanceP(root->val, root->left, insertPersistent(root->right, val));
+    return balanceP(root->val, insertPersistent(root->left, val), root->right);
+}
+
+PTree eraseMinPersistent(const PTree &root)
+{
+    if (!root->left)
+        return root->right;
+    return balanceP(root->val, eraseMinPersistent(root->left), root->right);
+}
+
+// key not present → the same version comes back, nothing is copied
+PTree erasePersistent(const PTree &root, int key)
+{
+    if (!root)
+        return root;
+    if (key < root->val)
+    {
+        PTree l = erasePersistent(root->left, key);
+        return l == root->left ? root : balanceP(root->val, std::move(l), root->right);
+    }
+    if (key > root->val)
+    {
+        PTree r = erasePersistent(root->right, key);
+        return r == root->right ? root : balanceP(root->val, root->left, std::move(r));
+    }
+    if (!root->left)
+        return root->right;
+    if (!root->right)
+        return root->left;
+    // 2 children: successor's value takes this spot
+    const PNode *succ = root->right.get();
+    while (succ->left)
+        succ = succ->left.get();
+    return balanceP(succ->val, root->left, eraseMinPersistent(root->right));
+}
+
+PTree bulkLoadPersistent(const vector<int> &sorted, int i, int j)
+{
+    if (i > j)
+        return nullptr;
+    int mid = i + (j - i + 1) / 2;
+    return makeP(sorted[mid], bulkLoadPersistent(sorted, i, mid - 1), bulkLoadPersistent(sorted, mid + 1, j));
+}
+
+bool searchBST(const PTree &root, int key)
+{
+    for (const PNode *node = root.get(); node;)
+    {
+        if (node->val == key)
+            return true;
+        node = key < node->val ? node->left.get() : node->right.get();
+    }
+    return false;
+}
+
+int floorBST(const PTree &root, int key)
+{
+    int ans = -1;
+    for (const PNode *node = root.get(); node;)
+    {
+        if (node->val == key)
+            return key;
+        if (node->val < key)
+        {
+            ans = node->val;
+            node = node->right.get();
+        }
+        else
+            node = node->left.get();
+    }
+    return ans;
+}
+
+// f(val) for every key in [lo, hi], in order; raw pointers, the caller's PTree keeps them alive
+template <class F>
+void scanPersistent(const PTree &root, int lo, int hi, F f)
+{
+    vector<const PNode *> st;
+    const PNode *node = root.get();
+    while (node || !st.empty())
+    {
+        while (node)
+        {
+            if (node->val < lo)
+                node = node->right.get(); // whole left side is < lo
+            else
+            {
+                st.push_back(node);
+                node = node->left.get();
+            }
+        }
+        if (st.empty())
+            break;
+        node = st.back();
+        st.pop_back();
+        if (node->val > hi)
+            break;
+        f(node->val);
+        node = node->right.get();
+    }
+}
+
+class PersistentBST
+{
+    PTree head;
+    mutable mutex headMu; // guards the head pointer only, held for a pointer copy
+    mutex writeMu;        // one writer at a time builds the next version
+
+    void publish(PTree next)
+    {
+        {
+            lock_guard<mutex> lock(headMu);
+            head.swap(next);
+        }
+        // `next` now holds the previous version; dropping it here (outside the lock)
+        // frees whatever no snapshot shares anymore
+    }
+
+public:
+    PersistentBST() = default;
+    PersistentBST(const vector<int> &sorted) : head(bulkLoadPersistent(sorted, 0, (int)sorted.size() - 1)) {}
+
+    // consistent view, readable for as long as it is held
+    PTree snapshot() const
+    {
+        lock_guard<mutex> lock(headMu);
+        return head;
+    }
+
+    void insert(int val)
+    {
+        lock_guard<mutex> lock(writeMu);
+        publish(insertPersistent(snapshot(), val));
+    }
+
+    void erase(int key)
+    {
+        lock_guard<mutex> lock(writeMu);
+        PTree cur = snapshot();
+        PTree next = erasePersistent(cur, key);
+        if (next != cur)
+            publish(std::move(next));
+    }
+};
+// insert / erase : O(log n) time, O(log n) new nodes per version, O(log n) stack
+// snapshot       : O(1), a refcount bump
+// search / floor / scan on a snapshot : O(log n) (+ output), never blocked by writers
+// SC : shared structure, old versions cost only the paths that changed since
+// releasing the last handle to a version frees its private nodes recursively (O(log n) stack)
+
+// ! LCA in BST
+TreeNode *lowestCommonAncestor(TreeNode *root, TreeNode *p, TreeNode *q)
+{
+    if (root->val < p->val && root->val < q->val)
+        return lowestCommonAncestor(root->right, p, q);
+    else if (root->val > p->val && root->val > q->val)
+        return lowestCommonAncestor(root->left, p, q);
     return root;
 }
 // Time  : O(n) visit each node once
 // Space : O(h) recursion stack
 
-// !BST two sum
-bool findTarget(TreeNode *root, int k)
-{
-    unordered_set<int> s;
-    bool res = false;
-    stack<TreeNode *> st;
-    while (root || !st.empty())
+// !BST two sum
+bool findTarget(TreeNode *root, int k)
+{
+    unordered_set<int> s;
+    bool res = false;
+    stack<TreeNode *> st;
+    while (root || !st.empty())
+    {
+        while (root)
+        {
+            st.push(root);
+            root = root->left;
+        }
+        TreeNode *curr = st.top();
+        st.pop();
+        // in(curr)
+        if (s.count(k - curr->val))
+            return true;
+        s.insert(curr->val);
+        root = curr->right;
+    }
+    return res;
+}
+// TC O(n)
+// SC O(n) unordered_Set
+
+// ! BST Iterator
+class BSTIterator
+{
+    stack<TreeNode *> st;
+
+    void pushAll(TreeNode *node)
+    {
+        while (node)
+        {
+            st.push(node);
+            node = node->left;
+        }
+    }
+
+public:
+    BSTIterator(TreeNode *root)
+    {
+        pushAll(root);
+    }
+
+    int next()
+    {
+        TreeNode *node = st.top();
+        st.pop();
+        pushAll(node->right);
+        return node->val;
+    }
+
+    bool hasNext() const
+    {
+        return !st.empty();
+    }
+};
+// Constructor: O(h)
+// next(): amortized O(1) Each node is pushed once and popped once.
+// Total stack ops = 2n → O(n) Spread across n next() calls → amortized O(1).
+// hasNext(): O(1)
+// SC: O(h)
+
+// ! two sum using bst iterator
+class BSTIterator
+{
+    stack<TreeNode *> st;
+    bool isLeft;
+
+    void pushAll(TreeNode *node)
+    {
+        while (node)
+        {
+            st.push(node);
+            node = isLeft ? node->left : node->right;
+        }
+    }
+
+public:
+    BSTIterator(TreeNode *root, bool left)
+    {
+        isLeft = left;
+        pushAll(root);
+    }
+
+    int next()
+    {
+        TreeNode *node = st.top();
+        st.pop();
+
+        if (isLeft)
+            pushAll(node->right);
+        else
+            pushAll(node->left);
+
+        return node->val;
+    }
+
+    bool hasNext()
+    {
+        return !st.empty();
+    }
+};
+
+bool findTarget(TreeNode *root, int k)
+{
+    if (!root)
+        return false;
+
+    BSTIterator l(root, true);
+    BSTIterator r(root, false);
+
+    int i = l.next();
+    int j = r.next();
+
+    while (i < j)
+    {
+        int sum = i + j;
+        if (sum == k)
+            return true;
+        else if (sum < k)
+        {
+            if (l.hasNext())
+                i = l.next();
+            else
+                break;
+        }
+        else
+        {
+            if (r.hasNext())
+                j = r.next();
+            else
+                break;
+        }
+    }
+    return false;
+}
+// TC O(N)
+// SC O(H)x2
+
+// ! BST cursor: seek / next / prev / range scan
+/*
+BSTIterator only starts at the min (or max) and only moves one way. The cursor
+keeps the whole root → current path on a stack, so it can move both ways:
+
+- seek(key)      : descend once, remember the deepest node with val >= key,
+                   cut the path there → lower bound in O(h)
+- seekFloor(key) : same with val <= key
+- next()         : right child? go right then all the way left
+                   else pop until we come up from a left child
+- prev()         : mirror image
+- scan(lo, hi, f): seek(lo), then next() while key <= hi
+                   → O(h + k) for k keys in range, instead of a full inorder
+
+Moving past either end makes the cursor invalid until the next seek.
+*/
+class BSTCursor
+{
+    TreeNode *root;
+    vector<TreeNode *> path; // root ... current, empty when invalid
+
+    void pushAll(TreeNode *node, bool left)
+    {
+        while (node)
+        {
+            path.push_back(node);
+            node = left ? node->left : node->right;
+        }
+    }
+
+    // one step in inorder (forward) or reverse inorder
+    bool step(bool forward)
+    {
+        if (path.empty())
+            return false;
+        TreeNode *node = path.back();
+        TreeNode *child = forward ? node->right : node->left;
+        if (child)
+        {
+            pushAll(child, forward); // leftmost of the right subtree (or mirror)
+            return true;
+        }
+        path.pop_back();
+        while (!path.empty() && (forward ? path.back()->right : path.back()->left) == node)
+        {
+            node = path.back();
+            path.pop_back();
+        }
+        return !path.empty();
+    }
+
+    // keep the path down to the last node that satisfied the bound
+    bool seekBound(int key, bool ceil)
+    {
+        path.clear();
+        size_t keep = 0;
+        for (TreeNode *node = root; node;)
+        {
+            path.push_back(node);
+            bool ok = ceil ? node->val >= key : node->val <= key;
+            if (ok)
+                keep = path.size();
+            // a hit may have a tighter bound further in; a miss only on the other side
+            node = ok == ceil ? node->left : node->right;
+        }
+        path.resize(keep);
+        return keep != 0;
+    }
+
+public:
+    BSTCursor(TreeNode *root) : root(root) {}
+
+    bool valid() const
+    {
+        return !path.empty();
+    }
+
+    int key() const
+    {
+        return path.back()->val;
+    }
+
+    bool seekFirst()
+    {
+        path.clear();
+        pushAll(root, true);
+        return valid();
+    }
+
+    bool seekLast()
+    {
+        path.clear();
+        pushAll(root, false);
+        return valid();
+    }
+
+    // smallest key >= key
+    bool seek(int key)
+    {
+        return seekBound(key, true);
+    }
+
+    // largest key <= key
+    bool seekFloor(int key)
+    {
+        return seekBound(key, false);
+    }
+
+    bool next()
+    {
+        return step(true);
+    }
+
+    bool prev()
+    {
+        return step(false);
+    }
+
+    // f(val) for every key in [lo, hi], in order
+    template <class F>
+    void scan(int lo, int hi, F f)
+    {
+        for (bool ok = seek(lo); ok && key() <= hi; ok = next())
+            f(key());
+    }
+};
+// seek / seekFloor : O(h)
+// next / prev      : amortized O(1), O(h) worst
+// scan             : O(h + k) for k keys in range
+// SC               : O(h) path
+
+// ! B+ tree ordered index
+/*
+A binary BST node gives 1 key per cache miss. A B+ tree node packs many sorted
+keys into one block of 4K bytes (K = 16 → one 64-byte line, K = 64 → 256 bytes),
+so a lookup over 100M keys touches ~log_K(n) blocks instead of ~27 nodes.
+
+- leaf: exactly one block. K - 5 keys (11 for K = 16, 59 for K = 64), then
+  the count and next/prev links for in-order and reverse scans; no child
+  pointers, and leaves are almost all of the tree
+- inner node: keys[0..cnt) with cnt <= K, child[0..cnt];
+  child[i] < keys[i] <= child[i+1]. Only inner nodes carry the child array
+  (~1 in K/2 nodes), so they are bigger than a block
+- no kind flag in the nodes: all leaves sit at the same depth, so the tree
+  keeps its height and every walk knows when it has reached a leaf
+- every node except the root is at least half full
+- searching inside a node = counting keys < x (or <= x), done with AVX2
+  compares when available, plain branch-free counting otherwise
+Keys are unique (set semantics).
+*/
+template <int K = 16>
+class BPlusTree
+{
+    static_assert(K % 16 == 0, "K must be a multiple of 16 (whole cache lines)");
+    static const int MIN = K / 2;    // inner nodes
+    static const int LEAF_K = K - 5; // keys per leaf, cnt + next/prev take the other 20 bytes
+    static const int LEAF_MIN = LEAF_K / 2;
+
+    struct Node // opaque: what a node is follows from its depth
+    {
+    };
+    struct alignas(64) Leaf : Node
+    {
+        int keys[LEAF_K];
+        int cnt = 0;
+        Leaf *next = nullptr, *prev = nullptr;
+    };
+    struct alignas(64) Inner : Node
+    {
+        int keys[K];
+        int cnt = 0;
+        Node *child[K + 1];
+    };
+    static_assert(sizeof(Leaf) == 4 * K, "a leaf is exactly one block");
+
+    Node *root;
+    int height = 0; // inner levels above the leaves
+    size_t n = 0;
+
+    static Leaf *asLeaf(Node *node) { return static_cast<Leaf *>(node); }
+    static const Leaf *asLeaf(const Node *node) { return static_cast<const Leaf *>(node); }
+    static Inner *asInner(Node *node) { return static_cast<Inner *>(node); }
+    static const Inner *asInner(const Node *node) { return static_cast<const Inner *>(node); }
+
+    // number of keys in node < x (LE = false) or <= x (LE = true)
+    template <bool LE, class T>
+    static int countKeys(const T *node, int x)
+    {
+        int c = 0;
+#ifdef __AVX2__
+        // a leaf's last group of 8 runs into its own cnt / next / prev words:
+        // still inside the block, and masked off by `valid`
+        __m256i vx = _mm256_set1_epi32(x);
+        for (int i = 0; i < node->cnt; i += 8)
+        {
+            __m256i k = _mm256_load_si256((const __m256i *)(node->keys + i));
+            // LE: key <= x  ⇔ !(key > x);  LT: key < x ⇔ x > key
+            __m256i m = LE ? _mm256_cmpgt_epi32(k, vx) : _mm256_cmpgt_epi32(vx, k);
+            unsigned bits = _mm256_movemask_ps(_mm256_castsi256_ps(m));
+            if (LE)
+                bits = ~bits & 0xff;
+            int valid = min(8, node->cnt - i);
+            c += __builtin_popcount(bits & ((1u << valid) - 1));
+        }
+#else
+        for (int i = 0; i < node->cnt; i++)
+            c += LE ? node->keys[i] <= x : node->keys[i] < x;
+#endif
+        return c;
+    }
+
+    const Leaf *findLeaf(int x) const
+    {
+        const Node *node = root;
+        for (int level = height; level > 0; level--)
+            node = asInner(node)->child[countKeys<true>(asInner(node), x)];
+        return asLeaf(node);
+    }
+
+    static void insertAt(int *arr, int cnt, int pos, int v)
+    {
+        for (int i = cnt; i > pos; i--)
+            arr[i] = arr[i - 1];
+        arr[pos] = v;
+    }
+    static void insertAt(Node **arr, int cnt, int pos, Node *v)
+    {
+        for (int i = cnt; i > pos; i--)
+            arr[i] = arr[i - 1];
+        arr[pos] = v;
+    }
+    template <class T>
+    static void eraseAt(T *arr, int cnt, int pos)
+    {
+        for (int i = pos; i + 1 < cnt; i++)
+            arr[i] = arr[i + 1];
+    }
+
+    // inserts key below node (`level` inner levels above the leaves);
+    // on split returns the new right sibling and its separator
+    Node *insert(Node *node, int level, int key, int &sep, bool &added)
+    {
+        if (level == 0)
+        {
+            Leaf *leaf = asLeaf(node);
+            int pos = countKeys<false>(leaf, key);
+            if (pos < leaf->cnt && leaf->keys[pos] == key)
+                return nullptr; // already present
+            added = true;
+            if (leaf->cnt < LEAF_K)
+            {
+                insertAt(leaf->keys, leaf->cnt++, pos, key);
+                return nullptr;
+            }
+            // split full leaf: upper half moves to a new right leaf
+            Leaf *right = new Leaf();
+            right->cnt = LEAF_K - LEAF_MIN;
+            copy(leaf->keys + LEAF_MIN, leaf->keys + LEAF_K, right->keys);
+            leaf->cnt = LEAF_MIN;
+            if (pos <= LEAF_MIN)
+                insertAt(leaf->keys, leaf->cnt++, pos, key);
+            else
+                insertAt(right->keys, right->cnt++, pos - LEAF_MIN, key);
+            right->next = leaf->next;
+            right->prev = leaf;
+            if (leaf->next)
+                leaf->next->prev = right;
+            leaf->next = right;
+            sep = right->keys[0];
+            return right;
+        }
+
+        Inner *in = asInner(node);
+        int pos = countKeys<true>(in, key);
+        int childSep;
+        Node *split = insert(in->child[pos], level - 1, key, childSep, added);
+        if (!split)
+            return nullptr;
+        if (in->cnt < K)
+        {
+            insertAt(in->keys, in->cnt, pos, childSep);
+            insertAt(in->child, in->cnt + 1, pos + 1, split);
+            in->cnt++;
+            return nullptr;
+        }
+        // split full inner node: K + 1 keys → MIN left, 1 up, K - MIN right
+        int keys[K + 1];
+        Node *child[K + 2];
+        copy(in->keys, in->keys + K, keys);
+        copy(in->child, in->child + K + 1, child);
+        insertAt(keys, K, pos, childSep);
+        insertAt(child, K + 1, pos + 1, split);
+
+        Inner *right = new Inner();
+        in->cnt = MIN;
+        copy(keys, keys + MIN, in->keys);
+        copy(child, child + MIN + 1, in->child);
+        sep = keys[MIN];
+        right->cnt = K - MIN;
+        copy(keys + MIN + 1, keys + K + 1, right->keys);
+        copy(child + MIN + 1, child + K + 2, right->child);
+        return right;
+    }
+
+    // leaf child i of p has LEAF_MIN - 1 keys: borrow from a sibling or merge with one
+    void fixLeafUnderflow(Inner *p, int i)
+    {
+        Leaf *c = asLeaf(p->child[i]);
+        Leaf *l = i > 0 ? asLeaf(p->child[i - 1]) : nullptr;
+        Leaf *r = i < p->cnt ? asLeaf(p->child[i + 1]) : nullptr;
+
+        if (l && l->cnt > LEAF_MIN) // borrow from left
+        {
+            insertAt(c->keys, c->cnt++, 0, l->keys[--l->cnt]);
+            p->keys[i - 1] = c->keys[0];
+            return;
+        }
+        if (r && r->cnt > LEAF_MIN) // borrow from right
+        {
+            c->keys[c->cnt++] = r->keys[0];
+            eraseAt(r->keys, r->cnt--, 0);
+            p->keys[i] = r->keys[0];
+            return;
+        }
+
+        // merge right into left (both siblings are at LEAF_MIN, the pair fits in one leaf)
+        if (!l)
+        {
+            l = c;
+            c = r;
+            i++;
+        }
+        copy(c->keys, c->keys + c->cnt, l->keys + l->cnt);
+        l->cnt += c->cnt;
+        l->next = c->next;
+        if (c->next)
+            c->next->prev = l;
+        eraseAt(p->keys, p->cnt, i - 1);
+        eraseAt(p->child, p->cnt + 1, i);
+        p->cnt--;
+        delete c;
+    }
+
+    // inner child i of p has MIN - 1 keys: borrow from a sibling or merge with one
+    void fixInnerUnderflow(Inner *p, int i)
     {
-        while (root)
+        Inner *c = asInner(p->child[i]);
+        Inner *l = i > 0 ? asInner(p->child[i - 1]) : nullptr;
+        Inner *r = i < p->cnt ? asInner(p->child[i + 1]) : nullptr;
+
+        if (l && l->cnt > MIN) // borrow from left
         {
-            st.push(root);
-            root = root->left;
+            insertAt(c->keys, c->cnt, 0, p->keys[i - 1]);
+            insertAt(c->child, c->cnt + 1, 0, l->child[l->cnt]);
+            p->keys[i - 1] = l->keys[l->cnt - 1];
+            c->cnt++;
+            l->cnt--;
+            return;
         }
-        TreeNode *curr = st.top();
-        st.pop();
-        // in(curr)
-        if (s.count(k - curr->val))
-            return true;
-        s.insert(curr->val);
-        root = curr->right;
+        if (r && r->cnt > MIN) // borrow from right
+        {
+            c->keys[c->cnt] = p->keys[i];
+            c->child[c->cnt + 1] = r->child[0];
+            p->keys[i] = r->keys[0];
+            eraseAt(r->keys, r->cnt, 0);
+            eraseAt(r->child, r->cnt + 1, 0);
+            c->cnt++;
+            r->cnt--;
+            return;
+        }
+
+        // merge right into left (both siblings are at MIN, the pair fits in one node)
+        if (!l)
+        {
+            l = c;
+            c = r;
+            i++;
+        }
+        l->keys[l->cnt] = p->keys[i - 1];
+        copy(c->keys, c->keys + c->cnt, l->keys + l->cnt + 1);
+        copy(c->child, c->child + c->cnt + 1, l->child + l->cnt + 1);
+        l->cnt += c->cnt + 1;
+        eraseAt(p->keys, p->cnt, i - 1);
+        eraseAt(p->child, p->cnt + 1, i);
+        p->cnt--;
+        delete c;
     }
-    return res;
-}
-// TC O(n)
-// SC O(n) unordered_Set
 
-// ! BST Iterator
-class BSTIterator
-{
-    stack<TreeNode *> st;
+    bool erase(Node *node, int level, int key)
+    {
+        if (level == 0)
+        {
+            Leaf *leaf = asLeaf(node);
+            int pos = countKeys<false>(leaf, key);
+            if (pos == leaf->cnt || leaf->keys[pos] != key)
+                return false;
+            eraseAt(leaf->keys, leaf->cnt--, pos);
+            return true;
+        }
+        Inner *in = asInner(node);
+        int pos = countKeys<true>(in, key);
+        if (!erase(in->child[pos], level - 1, key))
+            return false;
+        if (level == 1 && asLeaf(in->child[pos])->cnt < LEAF_MIN)
+            fixLeafUnderflow(in, pos);
+        else if (level > 1 && asInner(in->child[pos])->cnt < MIN)
+            fixInnerUnderflow(in, pos);
+        return true;
+    }
 
-    void pushAll(TreeNode *node)
+    static void destroy(Node *node, int level)
     {
-        while (node)
+        if (level == 0)
         {
-            st.push(node);
-            node = node->left;
+            delete asLeaf(node);
+            return;
         }
+        Inner *in = asInner(node);
+        for (int i = 0; i <= in->cnt; i++)
+            destroy(in->child[i], level - 1);
+        delete in;
     }
 
 public:
-    BSTIterator(TreeNode *root)
+    BPlusTree() : root(new Leaf()) {}
+    BPlusTree(const BPlusTree &) = delete;
+    BPlusTree &operator=(const BPlusTree &) = delete;
+    ~BPlusTree() { destroy(root, height); }
+
+    size_t size() const { return n; }
+
+    bool search(int key) const
     {
-        pushAll(root);
+        const Leaf *leaf = findLeaf(key);
+        int pos = countKeys<false>(leaf, key);
+        return pos < leaf->cnt && leaf->keys[pos] == key;
     }
 
-    int next()
+    // -1 when there is no floor, same convention as floorBST
+    int floor(int key) const
     {
-        TreeNode *node = st.top();
-        st.pop();
-        pushAll(node->right);
-        return node->val;
+        const Leaf *leaf = findLeaf(key);
+        int pos = countKeys<true>(leaf, key);
+        if (pos > 0)
+            return leaf->keys[pos - 1];
+        // separator may be stale after deletes: the floor is then the end of the previous leaf
+        return leaf->prev ? leaf->prev->keys[leaf->prev->cnt - 1] : -1;
     }
 
-    bool hasNext() const
+    // returns false if key was already present
+    bool insert(int key)
     {
-        return !st.empty();
+        bool added = false;
+        int sep;
+        Node *split = insert(root, height, key, sep, added);
+        if (split)
+        {
+            Inner *newRoot = new Inner();
+            newRoot->cnt = 1;
+            newRoot->keys[0] = sep;
+            newRoot->child[0] = root;
+            newRoot->child[1] = split;
+            root = newRoot;
+            height++;
+        }
+        n += added;
+        return added;
     }
-};
-// Constructor: O(h)
-// next(): amortized O(1) Each node is pushed once and popped once.
-// Total stack ops = 2n → O(n) Spread across n next() calls → amortized O(1).
-// hasNext(): O(1)
-// SC: O(h)
-
-// ! two sum using bst iterator
-class BSTIterator
-{
-    stack<TreeNode *> st;
-    bool isLeft;
 
-    void pushAll(TreeNode *node)
+    // returns false if key was not present
+    bool erase(int key)
     {
-        while (node)
+        if (!erase(root, height, key))
+            return false;
+        n--;
+        if (height > 0 && asInner(root)->cnt == 0)
         {
-            st.push(node);
-            node = isLeft ? node->left : node->right;
+            Inner *old = asInner(root);
+            root = old->child[0];
+            height--;
+            delete old;
         }
+        return true;
     }
 
-public:
-    BSTIterator(TreeNode *root, bool left)
+    // visits keys in [lo, hi] in order: one descent, then walk the leaf chain
+    template <class F>
+    void scan(int lo, int hi, F visit) const
     {
-        isLeft = left;
-        pushAll(root);
+        const Leaf *leaf = findLeaf(lo);
+        int pos = countKeys<false>(leaf, lo);
+        while (leaf)
+        {
+            for (; pos < leaf->cnt; pos++)
+            {
+                if (leaf->keys[pos] > hi)
+                    return;
+                visit(leaf->keys[pos]);
+            }
+            leaf = leaf->next;
+            pos = 0;
+        }
     }
 
-    int next()
+    // forward (isLeft = true) or reverse iterator, same interface as BSTIterator
+    class Iterator
     {
-        TreeNode *node = st.top();
-        st.pop();
+        const Leaf *leaf;
+        int pos;
+        bool isLeft;
 
-        if (isLeft)
-            pushAll(node->right);
-        else
-            pushAll(node->left);
+        void settle()
+        {
+            // skip empty leaves (only an empty root leaf can be empty)
+            while (leaf && (pos < 0 || pos >= leaf->cnt))
+            {
+                leaf = isLeft ? leaf->next : leaf->prev;
+                if (leaf)
+                    pos = isLeft ? 0 : leaf->cnt - 1;
+            }
+        }
 
-        return node->val;
-    }
+    public:
+        Iterator(const BPlusTree &t, bool left) : isLeft(left)
+        {
+            const Node *node = t.root;
+            for (int level = t.height; level > 0; level--)
+                node = asInner(node)->child[left ? 0 : asInner(node)->cnt];
+            leaf = asLeaf(node);
+            pos = left ? 0 : leaf->cnt - 1;
+            settle();
+        }
 
-    bool hasNext()
-    {
-        return !st.empty();
-    }
-};
+        int next()
+        {
+            int v = leaf->keys[pos];
+            pos += isLeft ? 1 : -1;
+            settle();
+            return v;
+        }
 
-bool findTarget(TreeNode *root, int k)
+        bool hasNext() const
+        {
+            return leaf != nullptr;
+        }
+    };
+};
+// search / floor : O(log_K n) node visits, each a few SIMD compares on one block
+// insert / erase : O(K · log_K n) shifting inside nodes, O(log_K n) blocks touched
+// scan           : O(log_K n + m) for m results, sequential over leaves
+// SC             : leaves are exactly 4K bytes for (K - 5) / 2 .. K - 5 keys (~6-12 B/key at K = 16,
+//                  ~4.3-8.7 B/key at K = 64); inner nodes add ~1/K on top, no per-key pointers
+
+// two sum, same two-pointer walk as the BSTIterator version
+template <int K>
+bool findTarget(const BPlusTree<K> &t, int k)
 {
-    if (!root)
+    typename BPlusTree<K>::Iterator l(t, true), r(t, false);
+    if (!l.hasNext())
         return false;
-
-    BSTIterator l(root, true);
-    BSTIterator r(root, false);
-
     int i = l.next();
     int j = r.next();
-
     while (i < j)
     {
         int sum = i + j;
@@ -1738,7 +5259,7 @@ bool findTarget(TreeNode *root, int k)
     return false;
 }
 // TC O(N)
-// SC O(H)x2
+// SC O(1)
 
 void recoverTree(TreeNode *root)
 {
@@ -1782,34 +5303,544 @@ void recoverTree(TreeNode *root)
                     first = prev;
                 second = curr;
             }
-            prev = curr;
-            curr = curr->right;
+            prev = curr;
+            curr = curr->right;
+        }
+    }
+    // cout<<first->val<<" "<<second->val;
+    swap(first->val, second->val);
+}
+// TC O(n)
+// SC O(1)
+
+// ! Inorder to BST
+TreeNode *buildBST(const int *nums, int i, int j, TreeArena *arena = nullptr)
+{
+    if (i > j)
+        return nullptr;
+    int mid = i + (j - i + 1) / 2;
+    TreeNode *node = newNode(nums[mid], arena);
+    node->left = buildBST(nums, i, mid - 1, arena);
+    node->right = buildBST(nums, mid + 1, j, arena);
+    return node;
+}
+TreeNode *buildBST(const vector<int> &nums, int i, int j, TreeArena *arena = nullptr)
+{
+    return buildBST(nums.data(), i, j, arena);
+}
+TreeNode *sortedArrayToBST(vector<int> &nums, TreeArena *arena = nullptr)
+{
+    TreeNode *res = buildBST(nums, 0, nums.size() - 1, arena);
+    return res;
+}
+// TC O(N) Every recursive call creates one node, Each element is used exactly once to create a node.
+// SC O(log₂ n) Because you choose the middle every time, the tree is height-balanced ≈ log₂ n
+
+// ! Bulk load, merge, split
+/*
+bulkLoad: buildBST over a raw sorted range [first, last), straight into an
+arena → balanced, n nodes, O(n).
+
+mergeBST: both trees are already sorted sequences — read them with BSTIterator,
+merge the two streams like merge sort, bulkLoad the result. O(n + m) and the
+result is balanced, vs (m log(n + m)) single inserts that can skew the tree.
+The input trees are not touched (free them / drop their arena afterwards).
+
+splitBST: walk one root-to-leaf path; every node goes to the "< key" side
+(and we continue in its right subtree) or to the ">= key" side (continue left).
+Re-links existing nodes, no allocation, O(h).
+*/
+TreeNode *bulkLoad(const int *first, const int *last, TreeArena *arena = nullptr)
+{
+    return buildBST(first, 0, int(last - first) - 1, arena);
+}
+TreeNode *bulkLoad(const vector<int> &sorted, TreeArena *arena = nullptr)
+{
+    return bulkLoad(sorted.data(), sorted.data() + sorted.size(), arena);
+}
+
+TreeNode *mergeBST(TreeNode *a, TreeNode *b, TreeArena *arena = nullptr)
+{
+    vector<int> merged;
+    BSTIterator l(a), r(b);
+    bool hasL = l.hasNext(), hasR = r.hasNext();
+    int x = hasL ? l.next() : 0, y = hasR ? r.next() : 0;
+    while (hasL || hasR)
+    {
+        if (hasL && (!hasR || x <= y))
+        {
+            merged.push_back(x);
+            hasL = l.hasNext();
+            if (hasL)
+                x = l.next();
+        }
+        else
+        {
+            merged.push_back(y);
+            hasR = r.hasNext();
+            if (hasR)
+                y = r.next();
+        }
+    }
+    return bulkLoad(merged, arena);
+}
+
+// {nodes < key, nodes >= key}
+pair<TreeNode *, TreeNode *> splitBST(TreeNode *root, int key)
+{
+    TreeNode *less = nullptr, *rest = nullptr;
+    TreeNode **lt = &less, **ge = &rest; // where the next node of each side hangs
+    while (root)
+    {
+        if (root->val < key)
+        {
+            *lt = root;
+            lt = &root->right;
+            root = root->right;
+        }
+        else
+        {
+            *ge = root;
+            ge = &root->left;
+            root = root->left;
+        }
+    }
+    *lt = *ge = nullptr;
+    return {less, rest};
+}
+// bulkLoad  TC O(n)      SC O(log n) recursion
+// mergeBST  TC O(n + m)  SC O(n + m) merged buffer + O(h1 + h2) iterator stacks
+// splitBST  TC O(h)      SC O(1), heights of both halves <= h
+
+// ! Eytzinger (BFS order) static BST
+/*
+Same balanced tree sortedArrayToBST builds, but stored implicitly in one array:
+    a[1] = root, children of k are 2k and 2k+1   (a[0] unused)
+
+- no pointers, the top levels share a handful of cache lines
+- the 16 great-great-grandchildren of k sit together at a[16k .. 16k+15],
+  so one prefetch per step hides the miss 4 levels ahead
+- descent is branchless: k = 2k + (a[k] < x), the loop count depends only on n
+
+After falling off the tree, the bits of k record the path (1 = went right):
+- lower bound (first >= x) = last node where we went LEFT  → k >> ffs(~k)
+- floor       (last <= x)  = last node where we went RIGHT → k >> ffs(k)
+*/
+class EytzingerBST
+{
+    vector<int> a;
+    size_t n;
+
+    // in-order walk of the implicit tree hands out the sorted keys
+    void fill(const vector<int> &sorted, size_t &i, size_t k)
+    {
+        if (k > n)
+            return;
+        fill(sorted, i, 2 * k);
+        a[k] = sorted[i++];
+        fill(sorted, i, 2 * k + 1);
+    }
+
+    // index of the first key >= x (0 if none)
+    size_t lowerBound(int x) const
+    {
+        const int *base = a.data();
+        size_t k = 1;
+        while (k <= n)
+        {
+            __builtin_prefetch(base + 16 * k);
+            k = 2 * k + (base[k] < x);
+        }
+        return k >> __builtin_ffsll(~k);
+    }
+
+    // index of the last key <= x (0 if none)
+    size_t lastLessEqual(int x) const
+    {
+        const int *base = a.data();
+        size_t k = 1;
+        while (k <= n)
+        {
+            __builtin_prefetch(base + 16 * k);
+            k = 2 * k + (base[k] <= x);
+        }
+        return k >> __builtin_ffsll(k);
+    }
+
+    // lowerBound (LE = false) or lastLessEqual (LE = true) for many keys at once.
+    // Levels 1..full are complete, so every lane does the same number of steps
+    // there: with AVX2 that part runs 8 lanes per gather, two vectors in flight.
+    // The (at most one) ragged last level is finished per key.
+    template <bool LE>
+    void descendBatch(const int *keys, size_t m, size_t *out) const
+    {
+        const int *base = a.data();
+        int full = 0;
+        while ((size_t(2) << full) - 1 <= n) // 2^(full+1) - 1 nodes fit
+            full++;
+        size_t i = 0;
+#ifdef __AVX2__
+        const __m256i one = _mm256_set1_epi32(1);
+        for (; i + 16 <= m && n < (size_t(1) << 30); i += 16)
+        {
+            __m256i x0 = _mm256_loadu_si256((const __m256i *)(keys + i));
+            __m256i x1 = _mm256_loadu_si256((const __m256i *)(keys + i + 8));
+            __m256i k0 = one, k1 = one;
+            for (int d = 0; d < full; d++)
+            {
+                __m256i v0 = _mm256_i32gather_epi32(base, k0, 4);
+                __m256i v1 = _mm256_i32gather_epi32(base, k1, 4);
+                k0 = _mm256_add_epi32(k0, k0);
+                k1 = _mm256_add_epi32(k1, k1);
+                if (LE)
+                {
+                    // right when a[k] <= x: k = 2k + 1 + (a[k] > x ? -1 : 0)
+                    k0 = _mm256_add_epi32(_mm256_add_epi32(k0, one), _mm256_cmpgt_epi32(v0, x0));
+                    k1 = _mm256_add_epi32(_mm256_add_epi32(k1, one), _mm256_cmpgt_epi32(v1, x1));
+                }
+                else
+                {
+                    // right when a[k] < x: k = 2k - (x > a[k] ? -1 : 0)
+                    k0 = _mm256_sub_epi32(k0, _mm256_cmpgt_epi32(x0, v0));
+                    k1 = _mm256_sub_epi32(k1, _mm256_cmpgt_epi32(x1, v1));
+                }
+            }
+            alignas(32) int32_t idx[16];
+            _mm256_store_si256((__m256i *)idx, k0);
+            _mm256_store_si256((__m256i *)(idx + 8), k1);
+            for (int j = 0; j < 16; j++)
+                out[i + j] = idx[j];
+        }
+#endif
+        // scalar lanes: independent descents, the CPU overlaps their misses
+        for (size_t j = i; j < m; j++)
+        {
+            size_t k = 1;
+            for (int d = 0; d < full; d++)
+                k = 2 * k + (LE ? base[k] <= keys[j] : base[k] < keys[j]);
+            out[j] = k;
+        }
+        for (size_t j = 0; j < m; j++)
+        {
+            size_t k = out[j];
+            while (k <= n)
+                k = 2 * k + (LE ? base[k] <= keys[j] : base[k] < keys[j]);
+            out[j] = LE ? k >> __builtin_ffsll(k) : k >> __builtin_ffsll(~k);
+        }
+    }
+
+public:
+    // nums must be sorted ascending
+    EytzingerBST(const vector<int> &nums) : a(nums.size() + 1), n(nums.size())
+    {
+        size_t i = 0;
+        fill(nums, i, 1);
+    }
+
+    bool search(int key) const
+    {
+        size_t k = lowerBound(key);
+        return k && a[k] == key;
+    }
+
+    // -1 when there is no floor/ceil, same convention as floorBST
+    int floor(int key) const
+    {
+        size_t k = lastLessEqual(key);
+        return k ? a[k] : -1;
+    }
+
+    int ceil(int key) const
+    {
+        size_t k = lowerBound(key);
+        return k ? a[k] : -1;
+    }
+
+    vector<bool> searchBatch(const vector<int> &keys) const
+    {
+        vector<size_t> idx(keys.size());
+        descendBatch<false>(keys.data(), keys.size(), idx.data());
+        vector<bool> res(keys.size());
+        for (size_t j = 0; j < keys.size(); j++)
+            res[j] = idx[j] && a[idx[j]] == keys[j];
+        return res;
+    }
+
+    vector<int> floorBatch(const vector<int> &keys) const
+    {
+        vector<size_t> idx(keys.size());
+        descendBatch<true>(keys.data(), keys.size(), idx.data());
+        vector<int> res(keys.size());
+        for (size_t j = 0; j < keys.size(); j++)
+            res[j] = idx[j] ? a[idx[j]] : -1;
+        return res;
+    }
+
+    size_t size() const { return n; }
+};
+// Build : O(n)
+// search/floor/ceil : O(log n), no branches on the data, ~1 cache miss per 4 levels
+// Space : n ints, no per-node pointers
+
+// ! Batched BST lookups
+/*
+Looking keys up one by one waits for one cache miss per level per key.
+The batch versions walk BATCH keys down the tree in lockstep: every round
+advances each still-active key by one level and prefetches its next node,
+so up to BATCH misses are in flight at once instead of one.
+*/
+const int BATCH = 16;
+
+vector<bool> searchBSTBatch(TreeNode *root, const vector<int> &keys)
+{
+    vector<bool> res(keys.size());
+    for (size_t base = 0; base < keys.size(); base += BATCH)
+    {
+        int m = min<size_t>(BATCH, keys.size() - base);
+        TreeNode *cur[BATCH];
+        for (int j = 0; j < m; j++)
+            cur[j] = root;
+        for (int active = m; active;)
+        {
+            active = 0;
+            for (int j = 0; j < m; j++)
+            {
+                TreeNode *node = cur[j];
+                if (!node)
+                    continue;
+                int key = keys[base + j];
+                if (node->val == key)
+                {
+                    res[base + j] = true;
+                    cur[j] = nullptr;
+                    continue;
+                }
+                node = key < node->val ? node->left : node->right;
+                __builtin_prefetch(node);
+                cur[j] = node;
+                active += node != nullptr;
+            }
+        }
+    }
+    return res;
+}
+
+vector<int> floorBSTBatch(TreeNode *root, const vector<int> &keys)
+{
+    vector<int> res(keys.size(), -1);
+    for (size_t base = 0; base < keys.size(); base += BATCH)
+    {
+        int m = min<size_t>(BATCH, keys.size() - base);
+        TreeNode *cur[BATCH];
+        for (int j = 0; j < m; j++)
+            cur[j] = root;
+        for (int active = m; active;)
+        {
+            active = 0;
+            for (int j = 0; j < m; j++)
+            {
+                TreeNode *node = cur[j];
+                if (!node)
+                    continue;
+                int key = keys[base + j];
+                if (node->val == key)
+                {
+                    res[base + j] = key;
+                    cur[j] = nullptr;
+                    continue;
+                }
+                if (node->val < key)
+                {
+                    res[base + j] = node->val;
+                    node = node->right;
+                }
+                else
+                    node = node->left;
+                __builtin_prefetch(node);
+                cur[j] = node;
+                active += node != nullptr;
+            }
         }
     }
-    // cout<<first->val<<" "<<second->val;
-    swap(first->val, second->val);
+    return res;
 }
-// TC O(n)
-// SC O(1)
 
-// ! Inorder to BST
-TreeNode *buildBST(vector<int> &nums, int i, int j)
+vector<bool> searchBSTBatch(const EytzingerBST &t, const vector<int> &keys)
 {
-    if (i > j)
-        return nullptr;
-    int mid = i + (j - i + 1) / 2;
-    TreeNode *node = new TreeNode(nums[mid]);
-    node->left = buildBST(nums, i, mid - 1);
-    node->right = buildBST(nums, mid + 1, j);
-    return node;
+    return t.searchBatch(keys);
 }
-TreeNode *sortedArrayToBST(vector<int> &nums)
+
+vector<int> floorBSTBatch(const EytzingerBST &t, const vector<int> &keys)
 {
-    TreeNode *res = buildBST(nums, 0, nums.size() - 1);
-    return res;
+    return t.floorBatch(keys);
 }
-// TC O(N) Every recursive call creates one node, Each element is used exactly once to create a node.
-// SC O(log₂ n) Because you choose the middle every time, the tree is height-balanced ≈ log₂ n
+// TC O(m·h) work like m single lookups, but ~BATCH (pointer tree) or 16 SIMD lanes
+//    (Eytzinger + AVX2) overlapping misses, so throughput is bounded by bandwidth, not latency
+// SC O(m) output
+
+// ! Compile-time fixed-shape tree
+/*
+For small trees whose shape never changes (decision stumps, 7..255 nodes) the
+pointers are pure overhead. StaticTree<N> stores the tree implicitly:
+
+    node i → children 2i+1, 2i+2   (heap order, level order = array order)
+
+padded up to the next complete tree (2^D - 1 slots), with a present flag per
+slot. It is built from the usual level-order list (NIL = "N", children of a
+null node are not listed, same as deserialize), at compile time if the
+initializer is constexpr.
+
+Because D is a compile-time constant, every traversal has a fixed trip count:
+- search / floor: exactly D steps of `i = 2i + 1 + (key > v[i])`, results
+  picked with bit masks instead of branches → unrolled, branch-free. Empty
+  slots hold NIL and are masked out of the result, so the loop doesn't
+  need the present flags (search(NIL) is false, like on a pointer tree).
+- not a big speed-up for single lookups: on the 255-node tree in
+  benchStatic, search is ~20% faster than searchBST (no mispredicts, no
+  pointer loads), but floor is ~20% SLOWER than floorBST (the mask select
+  is a dependency chain through all D steps, while the pointer walk
+  stops early). What this buys is no allocation, constexpr evaluation
+  and a fixed, data-independent cost per lookup.
+- levelOrder: a straight scan of the array
+- inorder: template recursion over slot indices → straight-line code
+No allocation anywhere; everything is constexpr.
+
+    constexpr StaticTree<7> stump({4, 2, 6, 1, 3, 5, 7});
+    static_assert(stump.search(5) && stump.floor(0) == -1);
+*/
+constexpr int NIL = INT_MIN; // "N" in a StaticTree initializer (so INT_MIN itself can't be a key)
+
+template <int N>
+class StaticTree
+{
+    static constexpr int depthFor(int n)
+    {
+        int d = 0;
+        while ((1 << d) - 1 < n)
+            d++;
+        return d;
+    }
+
+public:
+    static constexpr int DEPTH = depthFor(N);
+    static constexpr int CAP = (1 << DEPTH) - 1;
+
+private:
+    array<int, CAP> v{};        // NIL in empty slots
+    array<bool, CAP> present{};
+    int count = 0;
+
+    template <int I, class F>
+    constexpr void inorderAt(F &f) const
+    {
+        if constexpr (I < CAP)
+        {
+            if (present[I])
+            {
+                inorderAt<2 * I + 1>(f);
+                f(v[I]);
+                inorderAt<2 * I + 2>(f);
+            }
+        }
+    }
+
+public:
+    constexpr StaticTree()
+    {
+        for (int &x : v)
+            x = NIL;
+    }
+
+    // level-order values, NIL for missing children; throws (= compile error
+    // in a constant expression) if the tree is deeper than N allows
+    constexpr StaticTree(const int *levelOrder, size_t M)
+    {
+        for (int &x : v)
+            x = NIL;
+        if (M == 0 || levelOrder[0] == NIL)
+            return;
+        array<int, CAP> q{}; // slot of every non-null node, in BFS order
+        int head = 0, tail = 0;
+        v[0] = levelOrder[0];
+        present[0] = true;
+        q[tail++] = 0;
+        count = 1;
+        for (size_t t = 1; t < M; t++)
+        {
+            if (head == tail)
+                throw "StaticTree: more tokens than nodes";
+            int parent = q[head];
+            int slot = 2 * parent + 1 + (t % 2 == 0); // tokens alternate left, right
+            if (t % 2 == 0)
+                head++;
+            if (levelOrder[t] == NIL)
+                continue;
+            if (slot >= CAP)
+                throw "StaticTree: tree deeper than N allows";
+            v[slot] = levelOrder[t];
+            present[slot] = true;
+            q[tail++] = slot;
+            count++;
+        }
+    }
+    template <size_t M>
+    constexpr StaticTree(const int (&levelOrder)[M]) : StaticTree(levelOrder, M) {}
+
+    constexpr int size() const
+    {
+        return count;
+    }
+
+    constexpr bool search(int key) const
+    {
+        bool found = false;
+        int i = 0;
+#pragma GCC unroll 16
+        for (int d = 0; d < DEPTH; d++)
+        {
+            found |= (v[i] == key) & (v[i] != NIL); // an empty slot must not match search(NIL)
+            i = 2 * i + 1 + (key > v[i]);
+        }
+        return found;
+    }
+
+    // largest value <= key, -1 if none (same contract as floorBST)
+    constexpr int floor(int key) const
+    {
+        int ans = -1;
+        int i = 0;
+#pragma GCC unroll 16
+        for (int d = 0; d < DEPTH; d++)
+        {
+            // mask select: a ?: or max() here gets compiled into a mispredicting branch
+            int take = -int((v[i] != NIL) & (v[i] <= key)); // deeper hits on the path are always larger
+            ans = (v[i] & take) | (ans & ~take);
+            i = 2 * i + 1 + (key >= v[i]);
+        }
+        return ans;
+    }
+
+    // f(depth, val) in level order
+    template <class F>
+    constexpr void levelOrder(F f) const
+    {
+        for (int d = 0; d < DEPTH; d++)
+            for (int i = (1 << d) - 1; i < (2 << d) - 1; i++)
+                if (present[i])
+                    f(d, v[i]);
+    }
+
+    // f(val) in sorted order
+    template <class F>
+    constexpr void inorder(F f) const
+    {
+        inorderAt<0>(f);
+    }
+};
+// search / floor : exactly log2(N + 1) steps, unrolled, no branches on the data
+// levelOrder     : O(N) array scan
+// inorder        : O(N), straight-line code
+// SC             : 5 bytes per slot, no pointers, no heap
 
 // ! BST from preorder
 /*
@@ -1826,7 +5857,7 @@ Push new node to stack
 The last popped node is the parent for the right child.
 If nothing was popped, the node is the left child of stack top.
  */
-TreeNode *bstFromPreorder(vector<int> &preorder)
+TreeNode *bstFromPreorder(vector<int> &preorder, TreeArena *arena = nullptr)
 {
     if (preorder.empty())
         return nullptr;
@@ -1835,13 +5866,13 @@ TreeNode *bstFromPreorder(vector<int> &preorder)
     stack<TreeNode *> st;
 
     // First element is always root
-    TreeNode *root = new TreeNode(preorder[0]);
+    TreeNode *root = newNode(preorder[0], arena);
     st.push(root);
 
     // Process remaining elements
     for (int i = 1; i < preorder.size(); i++)
     {
-        TreeNode *node = new TreeNode(preorder[i]);
+        TreeNode *node = newNode(preorder[i], arena);
         TreeNode *parent = nullptr;
 
         /*
@@ -1920,6 +5951,1133 @@ int maxSumBST(TreeNode *root)
 // Time Complexity: O(N)
 // Space Complexity: O(H), where H is height of tree
 
+// ! Parallel bottom-up largest / max-sum BST (no recursion)
+/*
+largestBST recurses once per level: a 10^7-deep chain overflows the stack,
+and it runs on one core. Same Info combine, driven by arrays instead:
+
+1. toFlat → preorder arrays (iterative). In preorder every subtree is a
+   contiguous range [i, i + size[i]) and children come after parents, so
+   walking an index range BACKWARDS is a valid post-order for it.
+2. size[i] from one backward pass.
+3. Scan forward: a node whose subtree has ≤ grain nodes becomes a task
+   (skip over its whole range), bigger ones are "top" nodes. Tasks are
+   disjoint subtrees → independent, handed to a small pool via an atomic
+   counter.
+4. After the pool, the top nodes are combined backwards on one thread;
+   their children are either other top nodes (later in preorder) or task
+   roots (already done).
+Nothing recurses, so depth doesn't matter; a chain simply has no
+parallelism and runs through step 4.
+*/
+struct BSTInfo
+{
+    long long sum;
+    int mn, mx;
+    int size; // -1: not a BST
+};
+
+struct BSTScan
+{
+    long long maxSum = 0; // best BST sum, 0 for the empty BST like maxSumBST
+    int maxSize = 0;      // node count of the largest BST subtree
+};
+
+BSTScan scanBSTs(const FlatTree &t, int threads = thread::hardware_concurrency())
+{
+    BSTScan res;
+    int n = t.size();
+    if (n == 0)
+        return res;
+
+    vector<int32_t> size(n);
+    for (int i = n - 1; i >= 0; i--)
+        size[i] = 1 + (t.left[i] >= 0 ? size[t.left[i]] : 0) + (t.right[i] >= 0 ? size[t.right[i]] : 0);
+
+    threads = max(1, threads);
+    int grain = max(1 << 12, n / (8 * threads));
+    vector<pair<int, int>> tasks; // [begin, end) = one whole subtree
+    vector<int> top;
+    for (int i = 0; i < n;)
+    {
+        if (size[i] <= grain)
+        {
+            tasks.push_back({i, i + size[i]});
+            i += size[i];
+        }
+        else
+            top.push_back(i++);
+    }
+
+    vector<BSTInfo> info(n);
+    auto child = [&](int c) -> BSTInfo
+    { return c < 0 ? BSTInfo{0, INT_MAX, INT_MIN, 0} : info[c]; };
+    auto visit = [&](int i, BSTScan &best)
+    {
+        BSTInfo l = child(t.left[i]), r = child(t.right[i]);
+        int v = t.val[i];
+        if (l.size >= 0 && r.size >= 0 && v < r.mn && v > l.mx)
+        {
+            info[i] = {v + l.sum + r.sum, min(v, l.mn), max(v, r.mx), 1 + l.size + r.size};
+            best.maxSum = max(best.maxSum, info[i].sum);
+            best.maxSize = max(best.maxSize, info[i].size);
+        }
+        else
+            info[i] = {0, INT_MAX, INT_MIN, -1};
+    };
+
+    vector<BSTScan> local(threads);
+    atomic<size_t> nextTask{0};
+    auto worker = [&](int w)
+    {
+        for (size_t k; (k = nextTask++) < tasks.size();)
+            for (int i = tasks[k].second - 1; i >= tasks[k].first; i--)
+                visit(i, local[w]);
+    };
+    if (threads == 1 || tasks.size() == 1)
+        worker(0);
+    else
+    {
+        vector<thread> pool;
+        for (int w = 0; w < threads; w++)
+            pool.emplace_back(worker, w);
+        for (thread &th : pool)
+            th.join();
+    }
+
+    for (int k = top.size() - 1; k >= 0; k--)
+        visit(top[k], res);
+    for (BSTScan &b : local)
+    {
+        res.maxSum = max(res.maxSum, b.maxSum);
+        res.maxSize = max(res.maxSize, b.maxSize);
+    }
+    return res;
+}
+
+long long maxSumBSTParallel(TreeNode *root, int threads = thread::hardware_concurrency())
+{
+    return scanBSTs(toFlat(root), threads).maxSum;
+}
+
+int largestBSTSizeParallel(TreeNode *root, int threads = thread::hardware_concurrency())
+{
+    return scanBSTs(toFlat(root), threads).maxSize;
+}
+// Time  : O(n) work, ~O(n / threads + top nodes) span
+// Space : O(n) flat arrays + 20 bytes of Info per node, no recursion at any depth
+
+// ===============================
+//! Benchmarks
+// ===============================
+// Build with -O2 and call one of these from main().
+double msSince(chrono::steady_clock::time_point t)
+{
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - t).count();
+}
+
+// ! benchmark: per-node new vs arena (build + destroy)
+void benchArena(int n)
+{
+    vector<int> nums(n);
+    for (int i = 0; i < n; i++)
+        nums[i] = i;
+
+    auto t = chrono::steady_clock::now();
+    TreeNode *heapRoot = sortedArrayToBST(nums);
+    double heapBuild = msSince(t);
+    t = chrono::steady_clock::now();
+    freeTree(heapRoot);
+    double heapFree = msSince(t);
+
+    t = chrono::steady_clock::now();
+    double arenaBuild, arenaFree;
+    {
+        TreeArena arena;
+        sortedArrayToBST(nums, &arena);
+        arenaBuild = msSince(t);
+        t = chrono::steady_clock::now();
+    } // arena dropped here
+    arenaFree = msSince(t);
+
+    cout << "n=" << n << "\n";
+    cout << "new   : build " << heapBuild << " ms, destroy " << heapFree << " ms\n";
+    cout << "arena : build " << arenaBuild << " ms, destroy " << arenaFree << " ms\n";
+}
+
+// ! benchmark: text vs binary codec round trip
+void benchCodec(int n)
+{
+    vector<int> nums(n);
+    for (int i = 0; i < n; i++)
+        nums[i] = i * 7 - n; // mix of negative and positive values
+    TreeArena src;
+    TreeNode *tree = sortedArrayToBST(nums, &src);
+
+    auto t = chrono::steady_clock::now();
+    string text = serialize(tree);
+    double textEnc = msSince(t);
+    t = chrono::steady_clock::now();
+    {
+        TreeArena a;
+        deserialize(text, &a);
+    }
+    double textDec = msSince(t);
+
+    t = chrono::steady_clock::now();
+    string slowText = serialize1(tree);
+    double slowEnc = msSince(t);
+    t = chrono::steady_clock::now();
+    {
+        TreeArena a;
+        deserialize1(slowText, &a);
+    }
+    double slowDec = msSince(t);
+
+    t = chrono::steady_clock::now();
+    string bin = serializeBinary(tree);
+    double binEnc = msSince(t);
+    t = chrono::steady_clock::now();
+    {
+        TreeArena a;
+        deserializeBinary(bin, &a);
+    }
+    double binDec = msSince(t);
+
+    // MB/s measured against the size of each codec's own encoding
+    auto mbps = [](size_t bytes, double ms) { return bytes / 1e6 / (ms / 1e3); };
+    cout << "n=" << n << "\n";
+    cout << "text (to_string / stoi) : " << slowText.size() << " B, encode " << mbps(slowText.size(), slowEnc)
+         << " MB/s, decode " << mbps(slowText.size(), slowDec) << " MB/s, round trip " << slowEnc + slowDec << " ms\n";
+    cout << "text   : " << text.size() << " B, encode " << mbps(text.size(), textEnc)
+         << " MB/s, decode " << mbps(text.size(), textDec) << " MB/s, round trip " << textEnc + textDec << " ms\n";
+    cout << "binary : " << bin.size() << " B, encode " << mbps(bin.size(), binEnc)
+         << " MB/s, decode " << mbps(bin.size(), binDec) << " MB/s, round trip " << binEnc + binDec << " ms\n";
+    cout << "text speedup: encode " << slowEnc / textEnc << "x, decode " << slowDec / textDec << "x, same bytes "
+         << (slowText == text) << "\n";
+}
+
+// ! benchmark: pointer tree vs FlatTree traversals
+// Run under `perf stat -e cache-misses,cache-references` to see the miss counts;
+// the timings alone already show the gap once the tree is far bigger than LLC.
+void benchFlat(int n)
+{
+    // random insertion order → nodes of one subtree are scattered over the heap
+    vector<int> keys(n);
+    for (int i = 0; i < n; i++)
+        keys[i] = i;
+    srand(42);
+    for (int i = n - 1; i > 0; i--)
+        swap(keys[i], keys[rand() % (i + 1)]);
+    TreeNode *tree = nullptr;
+    for (int k : keys)
+        tree = insertIntoBST(tree, k);
+    FlatTree flat = toFlat(tree);
+
+    auto run = [](const char *name, auto fn)
+    {
+        auto t = chrono::steady_clock::now();
+        size_t out = fn();
+        cout << name << ": " << msSince(t) << " ms (" << out << ")\n";
+    };
+    cout << "n=" << n << "\n";
+    run("inorder    ptr ", [&] { return inorderIter(tree).size(); });
+    run("inorder    flat", [&] { return inorderIter(flat).size(); });
+    run("preorder   ptr ", [&] { return preorderIter(tree).size(); });
+    run("preorder   flat", [&] { return preorderIter(flat).size(); });
+    run("postorder  ptr ", [&] { return postorderTraversal(tree).size(); });
+    run("postorder  flat", [&] { return postorderTraversal(flat).size(); });
+    run("levelorder ptr ", [&] { return levelOrder(tree).size(); });
+    run("levelorder flat", [&] { return levelOrder(flat).size(); });
+    run("zigzag     ptr ", [&] { return zigzagLevelOrder(tree).size(); });
+    run("zigzag     flat", [&] { return zigzagLevelOrder(flat).size(); });
+    freeTree(tree);
+}
+
+// ! benchmark: pointer BST vs Eytzinger, point lookups
+// benchEytzinger(1000); benchEytzinger(1000000); benchEytzinger(100000000);
+void benchEytzinger(int n, int probes = 10000000)
+{
+    vector<int> nums(n);
+    for (int i = 0; i < n; i++)
+        nums[i] = 2 * i; // odd probes miss, even probes hit
+    TreeArena arena;
+    TreeNode *tree = sortedArrayToBST(nums, &arena);
+    EytzingerBST ey(nums);
+
+    vector<int> keys(probes);
+    srand(7);
+    for (int &k : keys)
+        k = int((uint64_t(rand()) * RAND_MAX + rand()) % (2 * uint64_t(n)));
+
+    long long check = 0;
+    auto t = chrono::steady_clock::now();
+    for (int k : keys)
+        check += searchBST(tree, k);
+    double ptrSearch = msSince(t);
+    t = chrono::steady_clock::now();
+    for (int k : keys)
+        check -= ey.search(k);
+    double eySearch = msSince(t);
+    t = chrono::steady_clock::now();
+    for (int k : keys)
+        check += floorBST(tree, k);
+    double ptrFloor = msSince(t);
+    t = chrono::steady_clock::now();
+    for (int k : keys)
+        check -= ey.floor(k);
+    double eyFloor = msSince(t);
+
+    cout << "n=" << n << " (" << probes << " probes, check " << check << " should be 0)\n";
+    cout << "searchBST " << ptrSearch * 1e6 / probes << " ns/op, Eytzinger search " << eySearch * 1e6 / probes << " ns/op\n";
+    cout << "floorBST  " << ptrFloor * 1e6 / probes << " ns/op, Eytzinger floor  " << eyFloor * 1e6 / probes << " ns/op\n";
+}
+
+// ! benchmark: one-at-a-time vs batched lookups
+void benchBatch(int n, int probes = 10000000)
+{
+    vector<int> nums(n);
+    for (int i = 0; i < n; i++)
+        nums[i] = 2 * i;
+    TreeArena arena;
+    TreeNode *tree = sortedArrayToBST(nums, &arena);
+    EytzingerBST ey(nums);
+
+    vector<int> keys(probes);
+    srand(7);
+    for (int &k : keys)
+        k = int((uint64_t(rand()) * RAND_MAX + rand()) % (2 * uint64_t(n)));
+
+    auto report = [&](const char *name, double ms)
+    { cout << name << ": " << ms * 1e6 / probes << " ns/key\n"; };
+    cout << "n=" << n << "\n";
+
+    long long check = 0;
+    auto t = chrono::steady_clock::now();
+    for (int k : keys)
+        check += searchBST(tree, k);
+    report("searchBST loop          ", msSince(t));
+    t = chrono::steady_clock::now();
+    vector<bool> hit = searchBSTBatch(tree, keys);
+    report("searchBSTBatch (pointer)", msSince(t));
+    t = chrono::steady_clock::now();
+    vector<bool> hitEy = searchBSTBatch(ey, keys);
+    report("searchBSTBatch (Eytz.)  ", msSince(t));
+
+    t = chrono::steady_clock::now();
+    for (int k : keys)
+        check += floorBST(tree, k);
+    report("floorBST loop           ", msSince(t));
+    t = chrono::steady_clock::now();
+    vector<int> fl = floorBSTBatch(tree, keys);
+    report("floorBSTBatch (pointer) ", msSince(t));
+    t = chrono::steady_clock::now();
+    vector<int> flEy = floorBSTBatch(ey, keys);
+    report("floorBSTBatch (Eytz.)   ", msSince(t));
+
+    cout << "results agree: " << (hit == hitEy && fl == flEy) << " (" << check << ")\n";
+}
+
+// ! benchmark: increasing keys into insertIntoBST vs BalancedBST
+void benchSkewed(int n)
+{
+    auto t = chrono::steady_clock::now();
+    {
+        TreeArena arena;
+        BalancedBST bal(&arena);
+        for (int i = 0; i < n; i++)
+            bal.insert(i);
+        double ms = msSince(t);
+        cout << "BalancedBST  n=" << n << ": " << ms << " ms, depth " << maxDepth(bal.getRoot())
+             << " (log2 n = " << log2((double)n) << ")\n";
+        for (int i = 0; i < n; i += 2)
+            bal.erase(i);
+        cout << "after deleting half: depth " << maxDepth(bal.getRoot()) << "\n";
+    }
+
+    // the plain BST degenerates into a list: keep it small, it is O(n²) and recursive
+    int small = min(n, 20000);
+    t = chrono::steady_clock::now();
+    TreeNode *plain = nullptr;
+    for (int i = 0; i < small; i++)
+        plain = insertIntoBST(plain, i);
+    cout << "insertIntoBST n=" << small << ": " << msSince(t) << " ms, depth " << maxDepth(plain) << "\n";
+    freeTree(plain);
+}
+
+// ! benchmark: pointer BST vs B+ tree, point lookups and range scans
+// benchBPlus(100000000) for the full-size run (~3.2 GB of TreeNodes)
+void benchBPlus(int n, int probes = 5000000, int scanLen = 100)
+{
+    vector<int> nums(n);
+    for (int i = 0; i < n; i++)
+        nums[i] = 2 * i;
+    TreeArena arena;
+    TreeNode *tree = sortedArrayToBST(nums, &arena);
+    auto t = chrono::steady_clock::now();
+    BPlusTree<16> bp;
+    for (int x : nums)
+        bp.insert(x);
+    cout << "n=" << n << ", B+ tree build " << msSince(t) << " ms\n";
+
+    vector<int> keys(probes);
+    srand(7);
+    for (int &k : keys)
+        k = int((uint64_t(rand()) * RAND_MAX + rand()) % (2 * uint64_t(n)));
+
+    long long check = 0;
+    t = chrono::steady_clock::now();
+    for (int k : keys)
+        check += searchBST(tree, k);
+    double ptrLookup = msSince(t);
+    t = chrono::steady_clock::now();
+    for (int k : keys)
+        check -= bp.search(k);
+    double bpLookup = msSince(t);
+
+    // range scan over the pointer tree: stack seek to lo, then BSTIterator-style walk
+    int probesScan = probes / 10;
+    t = chrono::steady_clock::now();
+    for (int q = 0; q < probesScan; q++)
+    {
+        int lo = keys[q], hi = lo + 2 * scanLen;
+        stack<TreeNode *> st;
+        for (TreeNode *node = tree; node;)
+        {
+            if (node->val >= lo)
+            {
+                st.push(node);
+                node = node->left;
+            }
+            else
+                node = node->right;
+        }
+        while (!st.empty() && st.top()->val <= hi)
+        {
+            TreeNode *node = st.top();
+            st.pop();
+            check += node->val;
+            for (node = node->right; node; node = node->left)
+                st.push(node);
+        }
+    }
+    double ptrScan = msSince(t);
+    t = chrono::steady_clock::now();
+    for (int q = 0; q < probesScan; q++)
+        bp.scan(keys[q], keys[q] + 2 * scanLen, [&](int v) { check -= v; });
+    double bpScan = msSince(t);
+
+    cout << "point lookup : BST " << ptrLookup * 1e6 / probes << " ns, B+ " << bpLookup * 1e6 / probes << " ns\n";
+    cout << "range scan " << scanLen << " keys : BST " << ptrScan * 1e6 / probesScan << " ns, B+ "
+         << bpScan * 1e6 / probesScan << " ns (check " << check << " should be 0)\n";
+}
+
+// ! benchmark: serial vs fork-join reductions, speedup by thread count
+void benchParallel(int n)
+{
+    vector<int> nums(n);
+    for (int i = 0; i < n; i++)
+        nums[i] = i;
+    TreeArena arena;
+    TreeNode *tree = sortedArrayToBST(nums, &arena);
+
+    auto time = [](auto fn)
+    {
+        auto t = chrono::steady_clock::now();
+        long long r = fn();
+        return make_pair(msSince(t), r);
+    };
+    auto serial = time([&] { return (long long)maxDepth(tree) + diameterOfBinaryTree(tree) +
+                                    maxPathSum(tree) + isValidBST(tree); });
+    cout << "n=" << n << " serial: " << serial.first << " ms\n";
+    for (int threads = 1; threads <= (int)thread::hardware_concurrency() * 2; threads *= 2)
+    {
+        auto par = time([&] { return (long long)maxDepthParallel(tree, threads) + diameterOfBinaryTreeParallel(tree, threads) +
+                                     maxPathSumParallel(tree, threads) + isValidBSTParallel(tree, threads); });
+        cout << "threads=" << threads << ": " << par.first << " ms, speedup " << serial.first / par.first
+             << (par.second == serial.second ? "" : "  RESULT MISMATCH") << "\n";
+    }
+}
+
+// ! benchmark: mutex-wrapped BST vs ConcurrentBST, 95% reads / 5% writes
+// benchConcurrent(1000000, 1); benchConcurrent(1000000, 8); benchConcurrent(1000000, 64);
+void benchConcurrent(int n, int threads, int opsPerThread = 1000000)
+{
+    vector<int> nums(n);
+    for (int i = 0; i < n; i++)
+        nums[i] = 2 * i;
+    srand(11);
+    for (int i = n - 1; i > 0; i--)
+        swap(nums[i], nums[rand() % (i + 1)]); // random order → expected O(log n) height
+
+    // writes insert odd keys / delete even ones; lookups are counted so they can't be optimized away
+    atomic<long long> hits{0};
+    auto runThreads = [&](auto op)
+    {
+        auto t = chrono::steady_clock::now();
+        vector<thread> pool;
+        for (int id = 0; id < threads; id++)
+            pool.emplace_back(op, id);
+        for (thread &th : pool)
+            th.join();
+        double ms = msSince(t);
+        return threads * (double)opsPerThread / (ms / 1e3) / 1e6; // Mops/s
+    };
+
+    TreeNode *plain = nullptr;
+    for (int x : nums)
+        plain = insertIntoBST(plain, x);
+    mutex mu;
+    auto lockedOps = [&](int id)
+    {
+        mt19937 rng(id);
+        long long found = 0;
+        for (int i = 0; i < opsPerThread; i++)
+        {
+            int key = rng() % (2 * n);
+            lock_guard<mutex> lock(mu);
+            if (rng() % 100 >= 5)
+                found += searchBST(plain, key);
+            else if (key & 1)
+                plain = insertIntoBST(plain, key);
+            else
+                plain = deleteNode(plain, key);
+        }
+        hits += found;
+    };
+    double locked = runThreads(lockedOps);
+    freeTree(plain);
+
+    ConcurrentBST cbst;
+    for (int x : nums)
+        cbst.insert(x);
+    auto lockFreeOps = [&](int id)
+    {
+        mt19937 rng(id);
+        ConcurrentBST::Reader reader(cbst);
+        long long found = 0;
+        for (int i = 0; i < opsPerThread; i++)
+        {
+            int key = rng() % (2 * n);
+            if (rng() % 100 >= 5)
+                found += reader.search(key);
+            else if (key & 1)
+                cbst.insert(key);
+            else
+                cbst.erase(key);
+        }
+        hits += found;
+    };
+    double lockFree = runThreads(lockFreeOps);
+
+    cout << "threads=" << threads << ": global mutex " << locked << " Mops/s, ConcurrentBST "
+         << lockFree << " Mops/s (" << hits << " hits)\n";
+}
+
+// ! benchmark: stack traversals (vector output) vs Morris engine (streaming sink)
+void benchMorris(int n)
+{
+    vector<int> nums(n);
+    for (int i = 0; i < n; i++)
+        nums[i] = i;
+    TreeArena arena;
+    TreeNode *tree = sortedArrayToBST(nums, &arena);
+
+    auto run = [](const char *name, auto fn)
+    {
+        auto t = chrono::steady_clock::now();
+        long long out = fn();
+        cout << name << ": " << msSince(t) << " ms (" << out << ")\n";
+    };
+    auto sumOf = [](const vector<int> &v)
+    {
+        long long s = 0;
+        for (int x : v)
+            s += x;
+        return s;
+    };
+    long long s = 0;
+    auto sink = [&](int v) { s += v; };
+    cout << "n=" << n << "\n";
+    run("inorderIter        ", [&] { return sumOf(inorderIter(tree)); });
+    run("morris In          ", [&] { s = 0; morrisTraverse<Order::In>(tree, sink); return s; });
+    run("preorderIter       ", [&] { return sumOf(preorderIter(tree)); });
+    run("morris Pre         ", [&] { s = 0; morrisTraverse<Order::Pre>(tree, sink); return s; });
+    run("postorderTraversal ", [&] { return sumOf(postorderTraversal(tree)); });
+    run("morris Post        ", [&] { s = 0; morrisTraverse<Order::Post>(tree, sink); return s; });
+}
+
+// ! benchmark: full inorder scan vs augmented BST for range sums
+void benchAugmented(int n, int queries = 1000)
+{
+    srand(5);
+    vector<int> keys(n);
+    for (int &k : keys)
+        k = rand() % (4 * n);
+    vector<pair<int, int>> ranges(queries);
+    for (auto &[lo, hi] : ranges)
+    {
+        lo = rand() % (4 * n);
+        hi = lo + rand() % n;
+    }
+
+    TreeNode *plain = nullptr;
+    for (int k : keys)
+        plain = insertIntoBST(plain, k);
+    AugNode *aug = nullptr;
+    auto t = chrono::steady_clock::now();
+    for (int k : keys)
+        aug = insertIntoBST(aug, k);
+    cout << "n=" << n << ", augmented build " << msSince(t) << " ms\n";
+
+    long long check = 0;
+    t = chrono::steady_clock::now();
+    for (auto [lo, hi] : ranges)
+        for (int v : inorderIter(plain)) // what the dashboards do today
+            if (v >= lo && v <= hi)
+                check += v;
+    double scan = msSince(t);
+    t = chrono::steady_clock::now();
+    for (auto [lo, hi] : ranges)
+        check -= rangeSum(aug, lo, hi);
+    double augMs = msSince(t);
+    cout << "rangeSum: inorder scan " << scan * 1e3 / queries << " us/query, augmented "
+         << augMs * 1e3 / queries << " us/query (check " << check << " should be 0)\n";
+
+    freeTree(plain);
+    vector<AugNode *> nodes;
+    collect(aug, nodes);
+    for (AugNode *node : nodes)
+        delete node;
+}
+
+// ! benchmark: per-query recursion (LCA-1) vs LCAIndex
+void benchLCA(int n, int queries = 1000000)
+{
+    vector<int> nums(n);
+    for (int i = 0; i < n; i++)
+        nums[i] = i;
+    TreeArena arena;
+    TreeNode *tree = sortedArrayToBST(nums, &arena);
+    vector<TreeNode *> nodes;
+    stack<TreeNode *> st;
+    st.push(tree);
+    while (!st.empty())
+    {
+        TreeNode *cur = st.top();
+        st.pop();
+        nodes.push_back(cur);
+        if (cur->left)
+            st.push(cur->left);
+        if (cur->right)
+            st.push(cur->right);
+    }
+    srand(3);
+    vector<pair<TreeNode *, TreeNode *>> qs(queries);
+    for (auto &[p, q] : qs)
+    {
+        p = nodes[rand() % n];
+        q = nodes[rand() % n];
+    }
+
+    auto t = chrono::steady_clock::now();
+    LCAIndex index(tree);
+    double build = msSince(t);
+    t = chrono::steady_clock::now();
+    vector<TreeNode *> fast = index.queryBatch(qs);
+    double fastMs = msSince(t);
+
+    int slowQueries = min(queries, 2000); // O(n) each
+    bool same = true;
+    t = chrono::steady_clock::now();
+    for (int i = 0; i < slowQueries; i++)
+        same &= lowestCommonAncestor1(tree, qs[i].first, qs[i].second) == fast[i];
+    double slowMs = msSince(t);
+
+    cout << "n=" << n << ": LCAIndex build " << build << " ms, " << fastMs * 1e6 / queries
+         << " ns/query; LCA-1 " << slowMs * 1e6 / slowQueries << " ns/query; agree " << same << "\n";
+}
+
+// ! benchmark: queue BFS vs level-synchronous frontier BFS on a wide tree
+void benchLevelOrder(int n, int threads = thread::hardware_concurrency())
+{
+    vector<int> nums(n);
+    for (int i = 0; i < n; i++)
+        nums[i] = i;
+    TreeArena arena;
+    TreeNode *tree = sortedArrayToBST(nums, &arena); // complete-ish: widest possible levels
+
+    auto t = chrono::steady_clock::now();
+    vector<vector<int>> slow = levelOrder(tree);
+    double slowMs = msSince(t);
+    t = chrono::steady_clock::now();
+    vector<vector<int>> fast = levelOrderParallel(tree, threads);
+    double fastMs = msSince(t);
+    t = chrono::steady_clock::now();
+    LevelBuffer buf = levelOrderBuffer(tree, threads);
+    double bufMs = msSince(t);
+    t = chrono::steady_clock::now();
+    int w1 = widthOfBinaryTree(tree);
+    double wSlow = msSince(t);
+    t = chrono::steady_clock::now();
+    int w2 = widthOfBinaryTreeParallel(tree, threads);
+    double wFast = msSince(t);
+
+    cout << "n=" << n << " threads=" << threads << ": levelOrder " << slowMs << " ms, parallel " << fastMs
+         << " ms, flat buffer " << bufMs << " ms (" << buf.vals.size() << " vals); width " << wSlow << " -> "
+         << wFast << " ms; agree " << (slow == fast && w1 == w2) << "\n";
+}
+
+// ! benchmark: map-based topView / verticalTraversal vs column offset arrays
+void benchVertical(int n)
+{
+    srand(11);
+    TreeArena arena;
+    TreeNode *tree = nullptr;
+    vector<int> keys(n);
+    for (int &k : keys)
+        k = rand();
+    for (int k : keys)
+        tree = insertIntoBST(tree, k, &arena); // random BST: depth ~ 2 ln n, wide columns
+
+    auto t = chrono::steady_clock::now();
+    vector<int> top1 = topView(tree);
+    double topSlow = msSince(t);
+    t = chrono::steady_clock::now();
+    vector<int> top2 = topViewColumns(tree);
+    double topFast = msSince(t);
+    t = chrono::steady_clock::now();
+    vector<vector<int>> v1 = verticalTraversal(tree);
+    double vSlow = msSince(t);
+    t = chrono::steady_clock::now();
+    vector<vector<int>> v2 = verticalTraversalColumns(tree);
+    double vFast = msSince(t);
+
+    cout << "n=" << n << ": topView " << topSlow << " -> " << topFast << " ms; verticalTraversal " << vSlow
+         << " -> " << vFast << " ms; agree " << (top1 == top2 && v1 == v2) << "\n";
+}
+
+// ! benchmark: buildTree (slices) / buildTree2 (hashmap) vs stack builders
+void benchBuildFromTraversals(int n)
+{
+    // random BST shape over 0..n-1 so values are distinct and depth stays O(log n)
+    vector<int> keys(n);
+    for (int i = 0; i < n; i++)
+        keys[i] = i;
+    shuffle(keys.begin(), keys.end(), mt19937(5));
+    TreeArena source;
+    TreeNode *tree = nullptr;
+    for (int k : keys)
+        tree = insertIntoBST(tree, k, &source);
+    vector<int> pre = preorderIter(tree), in = inorderIter(tree), post = postorderTraversal(tree);
+
+    auto t = chrono::steady_clock::now();
+    TreeArena a2;
+    TreeNode *hashed = buildTree2(pre, in, &a2);
+    double hashMs = msSince(t);
+    t = chrono::steady_clock::now();
+    TreeArena a3;
+    TreeNode *fastPre = buildTreePreIn(pre, in, &a3);
+    double preMs = msSince(t);
+    t = chrono::steady_clock::now();
+    TreeArena a4;
+    TreeNode *fastPost = buildTreePostIn(post, in, &a4);
+    double postMs = msSince(t);
+
+    int small = min(n, 5000); // buildTree copies vectors per call: O(n^2)
+    vector<int> smallPre(pre.begin(), pre.begin() + small), smallIn(smallPre);
+    sort(smallIn.begin(), smallIn.end()); // a preorder prefix is a root-connected part of the BST, so its inorder is sorted
+    t = chrono::steady_clock::now();
+    TreeArena a1;
+    buildTree(smallPre, smallIn, &a1);
+    double sliceMs = msSince(t);
+
+    bool same = preorderIter(hashed) == pre && preorderIter(fastPre) == pre && postorderTraversal(fastPost) == post &&
+                inorderIter(fastPre) == in && inorderIter(fastPost) == in;
+    cout << "n=" << n << ": buildTree2 " << hashMs << " ms, buildTreePreIn " << preMs << " ms, buildTreePostIn "
+         << postMs << " ms; buildTree " << sliceMs << " ms for n=" << small << "; agree " << same << "\n";
+}
+
+// ! benchmark: nightly batch as single inserts vs bulkLoad + mergeBST
+void benchBulk(int n, int batch)
+{
+    mt19937 rng(9);
+    vector<int> base(n), updates(batch);
+    for (int &x : base)
+        x = rng();
+    for (int &x : updates)
+        x = rng();
+    sort(base.begin(), base.end());
+
+    TreeArena a1;
+    TreeNode *t1 = bulkLoad(base, &a1);
+    auto t = chrono::steady_clock::now();
+    for (int x : updates)
+        t1 = insertIntoBST(t1, x, &a1);
+    double singleMs = msSince(t);
+
+    TreeArena a2, a3;
+    TreeNode *t2 = bulkLoad(base, &a2);
+    t = chrono::steady_clock::now();
+    sort(updates.begin(), updates.end());
+    TreeNode *merged = mergeBST(t2, bulkLoad(updates, &a2), &a3);
+    double bulkMs = msSince(t);
+    a2.release();
+
+    t = chrono::steady_clock::now();
+    auto [lo, hi] = splitBST(merged, updates[batch / 2]);
+    double splitMs = msSince(t);
+
+    vector<int> all = inorderIter(t1), halves = inorderIter(lo), upper = inorderIter(hi);
+    halves.insert(halves.end(), upper.begin(), upper.end());
+    cout << "n=" << n << " batch=" << batch << ": single inserts " << singleMs << " ms, bulkLoad+mergeBST "
+         << bulkMs << " ms (depth " << maxDepth(t1) << " vs " << maxDepth(lo) << "/" << maxDepth(hi)
+         << "), split " << splitMs * 1000 << " us; agree " << (all == halves) << "\n";
+}
+
+// ! benchmark: time-window query as full inorder + filter vs BSTCursor::scan
+void benchCursor(int n, int windows = 10000, int span = 100)
+{
+    vector<int> nums(n);
+    for (int i = 0; i < n; i++)
+        nums[i] = 2 * i; // timestamps
+    TreeArena arena;
+    TreeNode *tree = bulkLoad(nums, &arena);
+    srand(4);
+    vector<int> starts(windows);
+    for (int &s : starts)
+        s = rand() % (2 * n);
+
+    int fullWindows = min(windows, 20); // O(n) each
+    long long slowSum = 0, fastSum = 0;
+    auto t = chrono::steady_clock::now();
+    for (int w = 0; w < fullWindows; w++)
+        for (int v : inorderTraversal(tree))
+            if (v >= starts[w] && v <= starts[w] + span)
+                slowSum += v;
+    double slowMs = msSince(t);
+
+    BSTCursor cur(tree);
+    long long check = 0;
+    t = chrono::steady_clock::now();
+    for (int w = 0; w < windows; w++)
+    {
+        long long sum = 0;
+        cur.scan(starts[w], starts[w] + span, [&](int v)
+                 { sum += v; });
+        fastSum += sum;
+        if (w < fullWindows)
+            check += sum;
+    }
+    double fastMs = msSince(t);
+
+    cout << "n=" << n << ": inorder+filter " << slowMs * 1000 / fullWindows << " us/window, cursor scan "
+         << fastMs * 1000 / windows << " us/window; agree " << (slowSum == check) << " (" << fastSum << ")\n";
+}
+
+// ! benchmark: full scans under a global mutex vs scans on persistent snapshots
+// one writer keeps updating while one reader keeps scanning the whole tree
+void benchPersistent(int n, int millis = 300)
+{
+    vector<int> nums(n);
+    for (int i = 0; i < n; i++)
+        nums[i] = 2 * i;
+
+    auto run = [&](auto writeOp, auto scanOp)
+    {
+        atomic<bool> stop{false};
+        long long writes = 0, scans = 0;
+        double worst = 0; // slowest single write, ms
+        thread writer([&]
+                      {
+            mt19937 rng(1);
+            while (!stop)
+            {
+                auto t = chrono::steady_clock::now();
+                writeOp(rng() % (2 * n));
+                worst = max(worst, msSince(t));
+                writes++;
+            } });
+        thread reader([&]
+                      {
+            while (!stop)
+            {
+                scanOp();
+                scans++;
+            } });
+        this_thread::sleep_for(chrono::milliseconds(millis));
+        stop = true;
+        writer.join();
+        reader.join();
+        return make_tuple(writes, scans, worst);
+    };
+
+    TreeNode *plain = bulkLoad(nums);
+    mutex mu;
+    long long sink = 0;
+    auto [lw, ls, lworst] = run(
+        [&](int key)
+        {
+            lock_guard<mutex> lock(mu);
+            plain = (key & 1) ? insertIntoBST(plain, key) : deleteNode(plain, key);
+        },
+        [&]
+        {
+            lock_guard<mutex> lock(mu); // the whole scan blocks the writer
+            for (int v : inorderIter(plain))
+                sink += v;
+        });
+    freeTree(plain);
+
+    PersistentBST pbst(nums);
+    auto [pw, ps, pworst] = run(
+        [&](int key)
+        { (key & 1) ? pbst.insert(key) : pbst.erase(key); },
+        [&]
+        {
+            PTree snap = pbst.snapshot(); // writer keeps going while we scan
+            scanPersistent(snap, INT_MIN, INT_MAX, [&](int v)
+                           { sink += v; });
+        });
+
+    cout << "n=" << n << ", " << millis << " ms: global mutex " << lw << " writes (worst " << lworst << " ms) / " << ls
+         << " scans, persistent " << pw << " writes (worst " << pworst << " ms) / " << ps << " scans (" << (sink & 1)
+         << ")\n";
+
+    // monotonic keys (the BalancedBST workload): stays O(log n) per version
+    PersistentBST mono;
+    auto t = chrono::steady_clock::now();
+    for (int i = 0; i < n; i++)
+        mono.insert(i);
+    double monoMs = msSince(t);
+    auto depth = [](auto &self, const PNode *node) -> int
+    { return node ? 1 + max(self(self, node->left.get()), self(self, node->right.get())) : 0; };
+    cout << "  " << n << " increasing inserts: " << monoMs << " ms, depth " << depth(depth, mono.snapshot().get())
+         << "\n";
+}
+
+// ! benchmark: serialize/deserialize through one string vs streaming through a file
+void benchStream(int n, const char *path = "/tmp/tree_stream.txt")
+{
+    vector<int> keys(n);
+    for (int i = 0; i < n; i++)
+        keys[i] = i;
+    shuffle(keys.begin(), keys.end(), mt19937(3));
+    TreeArena src;
+    TreeNode *tree = nullptr;
+    for (int k : keys)
+        tree = insertIntoBST(tree, k, &src);
+
+    auto t = chrono::steady_clock::now();
+    string text = serialize(tree);
+    double serMs = msSince(t);
+    t = chrono::steady_clock::now();
+    TreeArena a1;
+    TreeNode *back1 = deserialize(text, &a1);
+    double deMs = msSince(t);
+
+    t = chrono::steady_clock::now();
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    bool wrote = fd >= 0 && serializeStream(tree, fd);
+    if (fd >= 0)
+        close(fd);
+    double serStreamMs = msSince(t);
+    t = chrono::steady_clock::now();
+    fd = open(path, O_RDONLY);
+    TreeArena a2;
+    TreeNode *back2 = fd >= 0 ? deserializeStream(fd, &a2) : nullptr;
+    if (fd >= 0)
+        close(fd);
+    double deStreamMs = msSince(t);
+    unlink(path);
+
+    vector<vector<int>> expect = levelOrder(tree);
+    bool same = wrote && levelOrder(back1) == expect && levelOrder(back2) == expect;
+    cout << "n=" << n << " (" << text.size() / 1e6 << " MB): serialize " << serMs << " ms, deserialize " << deMs
+         << " ms; serializeStream " << serStreamMs << " ms, deserializeStream " << deStreamMs
+         << " ms (file, 64 KB buffer); agree " << same << "\n";
+}
+
+// ! benchmark: pointer BST vs StaticTree on a fixed 255-node tree
+void benchStatic(int queries = 10000000)
+{
+    vector<int> nums(255);
+    for (int i = 0; i < 255; i++)
+        nums[i] = 2 * i;
+    TreeNode *tree = sortedArrayToBST(nums); // complete tree, same shape as below
+    // the same tree as a constexpr level-order initializer: heap slot i of a
+    // complete BST over 0, 2, .., 508 holds 2 * (inorder rank of slot i)
+    static constexpr StaticTree<255> fixed = []
+    {
+        int level[255] = {};
+        int rank = 0;
+        auto fill = [&](auto &self, int i) -> void
+        {
+            if (i >= 255)
+                return;
+            self(self, 2 * i + 1);
+            level[i] = 2 * rank++;
+            self(self, 2 * i + 2);
+        };
+        fill(fill, 0);
+        return StaticTree<255>(level);
+    }();
+
+    mt19937 rng(2);
+    vector<int> keys(1 << 16);
+    for (int &k : keys)
+        k = rng() % 520;
+    size_t mask = keys.size() - 1;
+
+    // search and floor timed apart: they don't behave the same (see the section comment)
+    long long a = 0, b = 0;
+    auto time = [&](auto query)
+    {
+        long long sum = 0;
+        auto t = chrono::steady_clock::now();
+        for (int i = 0; i < queries; i++)
+            sum += query(keys[i & mask]);
+        double ms = msSince(t);
+        return make_pair(ms * 1e6 / queries, sum);
+    };
+    auto [ptrSearch, s1] = time([&](int k)
+                                { return searchBST(tree, k); });
+    auto [staticSearch, s2] = time([&](int k)
+                                   { return fixed.search(k); });
+    auto [ptrFloor, f1] = time([&](int k)
+                               { return floorBST(tree, k); });
+    auto [staticFloor, f2] = time([&](int k)
+                                  { return fixed.floor(k); });
+    a = s1 + f1;
+    b = s2 + f2;
+
+    vector<int> in;
+    fixed.inorder([&](int x)
+                  { in.push_back(x); });
+    cout << "255 nodes: search pointer " << ptrSearch << " ns, StaticTree " << staticSearch << " ns; floor pointer "
+         << ptrFloor << " ns, StaticTree " << staticFloor << " ns; agree " << (a == b && in == nums) << "\n";
+    freeTree(tree);
+}
+
+// ! benchmark: forest of redundant trees — full walks vs hashes vs hash-consing
+void benchDedup(int trees, int shapes = 50, int nodesPerTree = 2000)
+{
+    // every tree = one of `shapes` templates, a few with a changed leaf
+    mt19937 rng(8);
+    vector<vector<int>> templates(shapes);
+    for (auto &keys : templates)
+    {
+        keys.resize(nodesPerTree);
+        for (int &k : keys)
+            k = rng() % 100000;
+    }
+    TreeArena forestArena;
+    vector<TreeNode *> forest(trees);
+    vector<int> kind(trees);
+    for (int i = 0; i < trees; i++)
+    {
+        kind[i] = rng() % shapes;
+        vector<int> keys = templates[kind[i]];
+        if (rng() % 4 == 0)
+            keys.back() = rng() % 100000; // near-duplicate
+        TreeNode *t = nullptr;
+        for (int k : keys)
+            t = insertIntoBST(t, k, &forestArena);
+        forest[i] = t;
+    }
+
+    // compare every tree with the previous tree built from the same template:
+    // near-duplicates differ only in one leaf, so a walk has to go deep
+    vector<pair<TreeNode *, TreeNode *>> pairs;
+    vector<TreeNode *> last(shapes, nullptr);
+    for (int i = 0; i < trees; i++)
+    {
+        if (last[kind[i]])
+            pairs.push_back({last[kind[i]], forest[i]});
+        last[kind[i]] = forest[i];
+    }
+
+    auto t = chrono::steady_clock::now();
+    int same1 = 0;
+    for (auto [a, b] : pairs)
+        same1 += isSameTree(a, b);
+    double walkMs = msSince(t);
+
+    TreeHasher hasher;
+    t = chrono::steady_clock::now();
+    for (TreeNode *tree : forest)
+        hasher.hash(tree);
+    double hashBuildMs = msSince(t);
+    t = chrono::steady_clock::now();
+    int same2 = 0;
+    for (auto [a, b] : pairs)
+        same2 += isSameTreeHashed(a, b, hasher);
+    double hashMs = msSince(t);
+
+    SubtreeInterner interner;
+    t = chrono::steady_clock::now();
+    unordered_map<TreeNode *, TreeNode *> canon;
+    for (TreeNode *tree : forest)
+        canon[tree] = interner.intern(tree);
+    double internMs = msSince(t);
+    int same3 = 0;
+    for (auto [a, b] : pairs)
+        same3 += canon[a] == canon[b];
+
+    cout << trees << " trees, " << pairs.size() << " pairs: isSameTree " << walkMs << " ms, hashed " << hashMs
+         << " ms (+" << hashBuildMs << " ms hashing), interned " << internMs << " ms then pointer compare; nodes " << interner.inputNodes()
+         << " -> " << interner.size() << " shared; agree " << (same1 == same2 && same2 == same3) << "\n";
+}
+
+// ! benchmark: recursive maxSumBST vs parallel bottom-up scan
+void benchMaxSumBST(int n, int threads = thread::hardware_concurrency())
+{
+    vector<int> keys(n);
+    for (int i = 0; i < n; i++)
+        keys[i] = i;
+    shuffle(keys.begin(), keys.end(), mt19937(6));
+    TreeArena arena;
+    TreeNode *tree = nullptr;
+    for (int k : keys)
+        tree = insertIntoBST(tree, k, &arena);
+    // scramble 1 value in 8 so BSTs stay local and their sums fit maxSumBST's int
+    mt19937 rng(7);
+    stack<TreeNode *> st;
+    st.push(tree);
+    while (!st.empty())
+    {
+        TreeNode *cur = st.top();
+        st.pop();
+        if (rng() % 8 == 0)
+            cur->val = rng() % n;
+        if (cur->left)
+            st.push(cur->left);
+        if (cur->right)
+            st.push(cur->right);
+    }
+
+    auto t = chrono::steady_clock::now();
+    ans = 0;
+    int slow = maxSumBST(tree);
+    double slowMs = msSince(t);
+    t = chrono::steady_clock::now();
+    long long fast = maxSumBSTParallel(tree, threads);
+    double fastMs = msSince(t);
+
+    // degenerate chain: the recursive version would overflow the stack here
+    TreeArena chainArena;
+    TreeNode *chain = newNode(0, &chainArena), *tail = chain;
+    for (int i = 1; i < n; i++)
+        tail = tail->right = newNode(i % 1000, &chainArena);
+    t = chrono::steady_clock::now();
+    int chainSize = largestBSTSizeParallel(chain, threads);
+    double chainMs = msSince(t);
+
+    cout << "n=" << n << " threads=" << threads << ": maxSumBST " << slowMs << " ms, parallel " << fastMs
+         << " ms; agree " << (slow == fast) << "; chain of " << n << " → largest BST " << chainSize << " nodes in "
+         << chainMs << " ms\n";
+}
+
 int main()
 {
 